@@ -44,7 +44,8 @@ public:
               llvm::FunctionType & scaFuncTy,
               const VectorShapeVec & argShapes,
               int vectorWidth,
-              bool hasPredicate) const;
+              bool hasPredicate,
+              int maxULPError = DefaultULPErrorBound) const;
 
   llvm::Module &getModule() const { return mod; }
   llvm::LLVMContext &getContext() const { return mod.getContext(); }
@@ -0,0 +1,61 @@
+//===- rv/analysis/AllTrueMaskAnalysis.h - all-threads-live analysis --*- C++ -*-===//
+//
+// Part of the RV Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef RV_ANALYSIS_ALLTRUEMASKANALYSIS_H
+#define RV_ANALYSIS_ALLTRUEMASKANALYSIS_H
+
+#include <llvm/IR/Value.h>
+#include <llvm/IR/BasicBlock.h>
+#include <llvm/IR/Dominators.h>
+#include "llvm/IR/PassManager.h"
+
+#include <map>
+#include <set>
+
+namespace rv {
+
+class VectorizationInfo;
+class UndeadMaskAnalysis;
+
+// this analysis is run by the backend to determine whether all lanes are active when a piece of code is executed.
+// for (...) {                   // vector loop body, full mask
+//   if (p) { .. } else { .. }
+//   *ptr = ..;                  // join block: (m && p) || (m && !p) == m
+//   if (rv_all(q)) {
+//     if (q) *ptr2 = ..;        // q is true in all lanes on this path
+//   }
+// }
+//
+// loads, stores and calls in blocks with an all-true predicate do not need a mask,
+// blends on an all-true mask select their first operand.
+class AllTrueMaskAnalysis {
+  VectorizationInfo & vecInfo;
+  UndeadMaskAnalysis & undeadMasks;
+  const llvm::DominatorTree & domTree;
+
+  std::map<std::pair<const llvm::Value*, const llvm::BasicBlock*>, bool> allTrueCache;
+  std::set<const llvm::Value*> pendingMasks; // cyclic masks (loop header phis) are not all-true
+
+  bool computeAllTrue(const llvm::Value & mask, const llvm::BasicBlock & where);
+
+  // whether @lhs || @rhs is all-true because one is the negation of the other (under an all-true common conjunct)
+  bool isComplementary(const llvm::Value & lhs, const llvm::Value & rhs, const llvm::BasicBlock & where);
+
+  // whether @where is dominated by the true edge of an rv_all(q) guard with q => @mask
+  bool isGuardedByAll(const llvm::Value & mask, const llvm::BasicBlock & where);
+
+public:
+  AllTrueMaskAnalysis(VectorizationInfo & vecInfo, UndeadMaskAnalysis & undeadMasks, llvm::FunctionAnalysisManager &FAM);
+
+  // whether all lanes of @mask are true whenever @where is executed
+  bool isAllTrue(const llvm::Value & mask, const llvm::BasicBlock & where);
+};
+
+} // namespace rv
+
+#endif // RV_ANALYSIS_ALLTRUEMASKANALYSIS_H
@@ -40,12 +40,13 @@ class UndeadMaskAnalysis {
   VectorizationInfo & vecInfo;
   const llvm::DominatorTree & domTree;
 
-  // whether @lhs ^ @lhsNegated implies @rhs ^ @rhsNegated
-  // (returns false if answer unknown)
-  bool implies(const llvm::Value & lhs, bool lhsNegated, const llvm::Value & rhs, bool rhsNegated);
   std::map<const llvm::Value*, const llvm::BasicBlock*> liveDominatorMap;
 
 public:
+  // whether @lhs ^ @lhsNegated implies @rhs ^ @rhsNegated
+  // (returns false if answer unknown)
+  static bool implies(const llvm::Value & lhs, bool lhsNegated, const llvm::Value & rhs, bool rhsNegated);
+
   UndeadMaskAnalysis(VectorizationInfo & vecInfo, llvm::FunctionAnalysisManager &FAM);
   bool isUndead(const llvm::Value & mask, const llvm::BasicBlock & where);
 };
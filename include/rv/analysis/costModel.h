@@ -10,6 +10,8 @@
 #define RV_ANALYSIS_COSTMODEL_H
 
 #include <cstddef>
+#include <cstdint>
+#include <functional>
 
 namespace llvm {
   class Instruction;
@@ -17,6 +19,8 @@ namespace llvm {
   class BasicBlock;
   class TargetTransformInfo;
   class Function;
+  class CallInst;
+  class Value;
 }
 
 namespace rv {
@@ -27,14 +31,47 @@ class VectorizationInfo;
 class Region;
 
 struct VectorMapping;
+class VectorShape;
 
 class CostModel {
+public:
+  // compute the shapes in @vecInfo for a candidate vector width (returns false if that is not possible)
+  using ShapeAnalysis = std::function<bool(VectorizationInfo & vecInfo)>;
+
+private:
   PlatformInfo & platInfo;
   Config & config;
   llvm::TargetTransformInfo & tti;
 
   bool needsReplication(const llvm::Instruction & inst) const;
 
+  // crude guess of the shape of @val in @region (in the absence of a vectorization analysis)
+  VectorShape guessShape(const llvm::Value & val, const Region & region) const;
+
+  // shape of @val from @vecInfo (if available), otw guess it
+  VectorShape getShape(const llvm::Value & val, const Region & region, const VectorizationInfo * vecInfo) const;
+
+  // whether @block will execute under a (potentially) partial mask
+  bool isPredicated(const llvm::BasicBlock & block, const Region & region, const VectorizationInfo * vecInfo) const;
+
+  // cost of moving all @vectorWidth lanes of @type in and/or out of a vector register
+  int getScalarizationCost(llvm::Type & type, size_t vectorWidth, bool insert, bool extract) const;
+
+  // cost of replicating @inst per lane (as the scalarizer of NatBuilder would do)
+  int getReplicationCost(const llvm::Instruction & inst, size_t vectorWidth, bool cascaded, const Region & region, const VectorizationInfo * vecInfo) const;
+
+  // cost of a widened load/store
+  int getMemoryCost(const llvm::Instruction & inst, size_t vectorWidth, const Region & region, const VectorizationInfo * vecInfo) const;
+
+  // cost of a widened call
+  int getCallCost(const llvm::CallInst & call, size_t vectorWidth, const Region & region, const VectorizationInfo * vecInfo) const;
+
+  // upper bound on the vector width for @region (available implementations, register sizes)
+  size_t boundWidthForRegion(const Region & region, size_t maxWidth) const;
+
+  // pick the width in [1, maxWidth] with the lowest @regionCost per scalar iteration
+  size_t pickCheapestWidth(size_t maxWidth, std::function<int64_t(size_t)> regionCost) const;
+
 public:
   CostModel(PlatformInfo & _platInfo, Config & _config);
 
@@ -53,6 +90,28 @@ public:
   // pick a vector width for a single block/the region
   size_t pickWidthForBlock(const llvm::BasicBlock & block, size_t maxWidth) const;
   size_t pickWidthForRegion(const Region & region, size_t maxWidth) const;
+
+  // pick a vector width for the region, costing each candidate width with the shapes computed by @analyzeShapes
+  size_t pickWidthForRegion(Region & region, size_t maxWidth, ShapeAnalysis analyzeShapes) const;
+
+  // estimated cost (reciprocal throughput) of a single execution of @inst in scalar code
+  int getScalarCost(const llvm::Instruction & inst) const;
+
+  // estimated cost of the widened @inst for @vectorWidth lanes (including scalarization overhead)
+  // uses the shapes in @vecInfo if available
+  int getVectorCost(const llvm::Instruction & inst, size_t vectorWidth, const Region & region, const VectorizationInfo * vecInfo = nullptr) const;
+
+  // estimated cost of one execution of @region at @vectorWidth (scalar code for @vectorWidth == 1)
+  int getRegionCost(const Region & region, size_t vectorWidth, const VectorizationInfo * vecInfo = nullptr) const;
+
+  // estimated cost of entering and leaving the vector loop @region (vector initial values, reductions)
+  int getLoopOverheadCost(const Region & region, size_t vectorWidth, const VectorizationInfo * vecInfo = nullptr) const;
+
+  // number of independent vector iterations to interleave per trip of the vector loop @region (1 for no interleaving)
+  size_t pickInterleaveCount(Region & region, size_t vectorWidth, ShapeAnalysis analyzeShapes) const;
+
+  // minimal trip count at which the loop @region at @vectorWidth beats the loop at @baseWidth (0 if it never does)
+  size_t getMinProfitableTripCount(Region & region, size_t vectorWidth, size_t baseWidth, ShapeAnalysis analyzeShapes) const;
 };
 
 }
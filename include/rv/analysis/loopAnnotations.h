@@ -55,6 +55,9 @@ namespace rv {
     // mandatory vector width
     Optional<iter_t> explicitVectorWidth;
 
+    // number of vector iterations to interleave per loop trip
+    Optional<iter_t> interleaveCount;
+
     // minimum dependence distance between two loop iterations
     Optional<iter_t> minDepDist;
 
@@ -11,6 +11,7 @@
 
 #include <llvm/IR/Function.h>
 #include <llvm/IR/Instructions.h>
+#include <llvm/IR/IRBuilder.h>
 #include <llvm/Analysis/LoopInfo.h>
 #include <llvm/IR/Constant.h>
 #include <llvm/Transforms/Utils/ValueMapper.h>
@@ -21,6 +22,7 @@
 
 #include <set>
 #include <map>
+#include <vector>
 
 namespace llvm {
   class Constant;
@@ -45,6 +47,12 @@ class StridePattern {
     return VectorShape::strided(inc, vectorWidth * inc); // TODO fix alignment
   }
 
+  // whether this is a pointer induction (@inc counts bytes)
+  bool isPointer() const { return phi->getType()->isPointerTy(); }
+
+  // the value of @val advanced by @amount (in units of @inc, bytes for pointer inductions)
+  llvm::Value & createOffset(llvm::IRBuilder<> & builder, llvm::Value & val, int64_t amount, const llvm::Twine & name = "") const;
+
   void print(llvm::raw_ostream & out) const;
   void dump() const;
 };
@@ -58,16 +66,22 @@ public:
   RedKind kind;
   // the instructions that make up this reduction pattern
   InstSet elements;
+  // (ArgMin/ArgMax) the min/max reduction whose updates select the index
+  Reduction * keyRed;
+  // (min/max) the index reductions that follow this reduction
+  std::vector<Reduction*> argReds;
 
   Reduction(InstSet _elements)
   : levelLoop(nullptr)
   , kind(RedKind::Bot)
   , elements(_elements)
+  , keyRed(nullptr)
   {}
 
   Reduction(llvm::Loop & _levelLoop, RedKind _kind)
   : levelLoop(&_levelLoop)
   , kind(_kind)
+  , keyRed(nullptr)
   {}
 
 
@@ -75,6 +89,7 @@ public:
   : levelLoop(&_levelLoop)
   , kind(RedKind::Bot)
   , elements()
+  , keyRed(nullptr)
   {
     elements.insert(&_seedElem);
   }
@@ -95,6 +110,9 @@ public:
   bool add(llvm::Instruction & elem) { return elements.insert(&elem).second; }
   void erase(llvm::Instruction & elem) { elements.erase(&elem); }
 
+  // whether the running value is observed by non-elements inside of @levelLoop (prefix scan)
+  bool isScan() const;
+
   void dump() const;
   void print(llvm::raw_ostream & out) const;
 };
@@ -121,6 +139,9 @@ class ReductionAnalysis {
   // check whether this instruction has a general stride pattern
   StridePattern * tryMatchStridePattern(llvm::PHINode & headerPhi);
 
+  // check whether @red tracks the index of a min/max reduction ("idx.next = select c, i, idx")
+  bool tryMatchArgReduction(Reduction & red);
+
 
   // returns true if the value of this instruction can be recomputed even if loop iterations execute in parallel/or SIMD fashing
   bool canReconstructInductively(llvm::Instruction & inst) const { return getStrideInfo(inst); }
@@ -13,6 +13,7 @@
 #include "llvm/ADT/StringRef.h"
 
 namespace llvm {
+  class CallInst;
   class Constant;
   class Instruction;
   class Type;
@@ -32,13 +33,21 @@ enum class RedKind : int64_t {
   UMax = 6,
   SMin = 7,
   UMin = 8,
+  FMax = 9, // maxnum
+  FMin = 10, // minnum
+  Xor = 11,
+  ArgMax = 12, // index of the max element (tracks a max reduction)
+  ArgMin = 13, // index of the min element (tracks a min reduction)
 
-  Enum_End = 9
+  Enum_End = 14
 };
 
 // join operator
 RedKind JoinKinds(RedKind A, RedKind B);
 
+// whether this kind selects one of its inputs (min/max)
+bool IsMinMaxKind(RedKind red);
+
 llvm::StringRef to_string(RedKind red);
 bool from_string(llvm::StringRef redKindText, RedKind & oRedKind);
 
@@ -48,6 +57,9 @@ llvm::Constant& GetNeutralElement(RedKind redKind, llvm::Type & chainType);
 // try to infer the reduction kind of the operator implemented by inst
 RedKind InferInstRedKind(llvm::Instruction & inst);
 
+// reduction kind of a (min/max) intrinsic call
+RedKind InferCallRedKind(llvm::CallInst & call);
+
 }
 
 #endif // RV_ANALYSIS_REDUCTIONS_H
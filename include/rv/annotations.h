@@ -14,6 +14,7 @@
 namespace llvm {
   class Function;
   class PHINode;
+  class Instruction;
 }
 
 namespace rv {
@@ -22,6 +23,10 @@ namespace rv {
 
   void SetReductionHint(llvm::PHINode & loopHeaderPhi, RedKind redKind);
   RedKind ReadReductionHint(const llvm::PHINode & loopHeaderPhi);
+
+  // the first lane of the strided pointer @ptrInst is aligned to @alignment bytes (an alignment of 1 drops the hint)
+  void SetAlignmentHint(llvm::Instruction & ptrInst, unsigned alignment);
+  unsigned ReadAlignmentHint(const llvm::Instruction & ptrInst);
 }
 
 #endif
@@ -39,9 +39,12 @@ struct Config {
 
 // native configuration (backend)
   bool scalarizeIndexComputation;
-  bool useScatterGatherIntrinsics;
+  bool useScatterGatherIntrinsics; // otw varying accesses are scalarized per lane (disabled with RV_DISABLE_GATHER)
+  bool useSafeAddressGather; // issue unmasked gathers/scatters with inactive lanes redirected to a scratch slot (where cheaper)
+  bool useActiveLaneLoops; // replicate instructions under sparse masks in a loop over the active lanes (where cheaper)
   bool enableMaskedMove;
-  bool enableInterleaved;
+  bool enableBlendStores; // masked stores to dereferenceable memory become load-blend-store (not thread safe: inactive lanes are written back)
+  bool enableInterleaved; // strided accesses of a group become one wide access and shuffles (RV_INTERLEAVED)
   bool useSafeDivisors; // blend-in safe divisors to eliminate spurious arithmetic exceptions
 
 // optimization flags
@@ -52,6 +55,22 @@ struct Config {
   bool enableHeuristicBOSCC;
   bool enableCoherentIF;
   bool enableOptimizedBlends;
+  bool enableSinCosFusion; // sin/cos calls on the same operand share one sincos call
+  bool enablePowSpecialization; // pow calls with a constant exponent become multiplication chains (or exp2(k*log2(x)) under afn)
+
+// loop vectorizer
+  // emit a narrower vector loop (dispatched on the trip count) for the remainder of the full width loop
+  bool enableMultiVersioning;
+  // run the last partial iteration as a masked vector iteration instead of a scalar remainder loop
+  bool enableTailFolding;
+  // vectorize the scalar remainder loop at half the vector width
+  bool enableHalfWidthEpilogue;
+  // also vectorize loops without vectorization annotations (guarded by runtime alias checks where necessary)
+  bool enableAutoVectorization;
+  // vectorize loops with data-dependent early exits (lanes past the exiting lane execute speculatively)
+  bool enableEarlyExits;
+  // run scalar iterations until a contiguous access stream is aligned to the vector size
+  bool enableAlignmentPeeling;
 
 // greedy inter-procedural vectorizatoin
   bool enableGreedyIPV;
@@ -60,16 +79,24 @@ struct Config {
   // unit for maxULPErrorBound is tenth of ULP (a value of 10 implies that an ULP error of <= 1.0 is acceptable)
   int maxULPErrorBound;
 
+  // rank calls into the target's vector math library (-fveclib, eg glibc libmvec) ahead of inlined SLEEF code
+  bool preferVectorLibrary;
+
 // target features
   bool useVE;
   bool useSSE;
   bool useAVX;
   bool useAVX2;
   bool useAVX512;
+  bool useAVX512CD; // conflict detection (vpconflict)
+  bool useAVX512VL; // AVX-512 instructions on 128 and 256 bit vectors
   bool useNEON;
   bool useADVSIMD;
 
 
+  // predicates live in dedicated mask registers (AVX-512 k-registers) rather than in lane-sized vector registers
+  bool hasMaskRegisters() const { return useAVX512; }
+
   void print(llvm::raw_ostream&) const;
 
   // create default configuration (RV_ARCH env var)
@@ -33,6 +33,7 @@ namespace rv {
     Index = 5, // prefix sum of mask vector (only defined where the mask is set)
     Mask = 6, // Gets the current execution mask
     Compact = 7, // rv_compact(V, M) returns the V compacted according to M
+    Expand = 8, // rv_expand(V, M) distributes the leading elements of V to the lanes set in M (inverse of rv_compact)
 
   // data intrinsics
     Extract = 100, // rv_extract(V, L) returns the L-th lane of V as a uniform value (lane broadcast)
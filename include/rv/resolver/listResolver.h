@@ -59,7 +59,7 @@ public:
 
   void print(llvm::raw_ostream & out) const override;
 
-  std::unique_ptr<FunctionResolver> resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredication, llvm::Module & destModule) override;
+  std::unique_ptr<FunctionResolver> resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredication, int maxULPError, llvm::Module & destModule) override;
 
 private:
   llvm::Module & destModule;
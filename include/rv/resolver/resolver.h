@@ -20,12 +20,14 @@ namespace llvm {
   class FunctionType;
   class Function;
   class Module;
+  class CallInst;
   class raw_ostream;
 }
 
 namespace rv {
 
 // represents an abstract notion of cost associated with a function.
+// Lower is better. A cost of 1 (the default) is a call to an existing vector function (see PlatformInfo::getResolver).
 struct
 FunctionCost {
   size_t cost;
@@ -65,12 +67,24 @@ public:
   virtual VectorShape requestResultShape() = 0;
 };
 
+// use the ULP error bound configured for the resolver (see Config::maxULPErrorBound)
+const int DefaultULPErrorBound = -1;
+
+// maximal ULP error (in tenths of ULP) that the call site @call admits for its vector implementation.
+// This is @defaultBound unless the fast-math flags or !fpmath metadata of @call relax it.
+int GetCallSiteULPBound(const llvm::CallInst & call, int defaultBound);
+
 // abstract function resolver interface
 class
 ResolverService {
 public:
+  // @maxULPError is the precision the call site requires (in tenths of ULP) or DefaultULPErrorBound.
   virtual ~ResolverService();
-  virtual std::unique_ptr<FunctionResolver> resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, llvm::Module & destModule) = 0;
+  virtual std::unique_ptr<FunctionResolver> resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, int maxULPError, llvm::Module & destModule) = 0;
+
+  // lower bound on the cost estimate of any FunctionResolver returned by resolve().
+  // This is queried before resolve(), which may already generate code (eg recursive vectorization).
+  virtual FunctionCost getCostLowerBound() const { return FunctionCost{1}; }
 
   void dump() const;
   virtual void print(llvm::raw_ostream & out) const;
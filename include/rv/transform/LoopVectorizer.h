@@ -26,6 +26,8 @@ namespace llvm {
   class PostDominatorTree;
   class MemoryDependenceResults;
   class BranchProbabilityInfo;
+  class LoopAccessInfo;
+  class Instruction;
 }
 
 
@@ -76,9 +78,25 @@ private:
 
   bool canVectorizeLoop(llvm::Loop &L);
 
+  // analyze the memory dependences of the unannotated loop \p L and set its minimal dependence distance in \p mdAnnot
+  // returns nullptr if the loop can not be vectorized
+  std::unique_ptr<llvm::LoopAccessInfo> analyzeMemoryDependences(llvm::Loop &L, LoopMD & mdAnnot);
+
+  // guard \p L by the runtime alias checks of \p accessInfo, the original loop runs if they fail
+  // returns the (never vectorized) loop that runs if the checks fail
+  llvm::Loop* versionLoopForAliasing(llvm::Loop &L, const llvm::LoopAccessInfo & accessInfo);
+
+  // undo versionLoopForAliasing (vectorization bailed): \p L runs unconditionally and \p fallbackLoop is deleted
+  void undoAliasVersioning(llvm::Loop &L, llvm::Loop & fallbackLoop);
+
+  // peel scalar iterations off \p L until a contiguous access stream is aligned for \p VectorWidth
+  // returns the (now aligned) pointer of that stream in \p L or nullptr if nothing was peeled
+  llvm::Instruction* peelForAlignment(llvm::Loop &L, int VectorWidth);
+
   // convert L into a vectorizable loop
   // this will create a new scalar loop that can be vectorized directly with RV
-  llvm::Loop* transformToVectorizableLoop(llvm::Loop &L, int VectorWidth, int tripAlign, ValueSet & uniformOverrides);
+  // the vector loop is entered for at least max(VectorWidth, minTripCount) iterations
+  llvm::Loop* transformToVectorizableLoop(llvm::Loop &L, int VectorWidth, int tripAlign, int minTripCount, ValueSet & uniformOverrides, ValueSet & derefAccesses);
 
   bool canAdjustTripCount(llvm::Loop &L, int VectorWidth, int TripCount);
 
@@ -90,6 +108,9 @@ private:
   int getTripAlignment(llvm::Loop & L);
 
   bool vectorizeLoop(llvm::Loop &L);
+
+  // vectorize \p L with \p VectorWidth keeping a scalar remainder loop (L itself)
+  bool vectorizeLoopWithWidth(llvm::Loop &L, int VectorWidth, int tripAlign, int minTripCount);
   bool vectorizeLoopOrSubLoops(llvm::Loop &L);
 };
 
@@ -28,6 +28,9 @@ namespace rv {
 // so the IR polisher tries to replace these by vectors of
 // i32/i64 instead. Note that this requires SSE41/AVX2 for
 // the integer vector instructions.
+// On targets with mask registers (AVX-512) the <n x i1> masks
+// are kept so that they are allocated to k-registers and blends
+// fold into merge-masked instructions.
 class IRPolisher {
   llvm::Function &F;
   llvm::Type* boolVector;
@@ -67,6 +70,7 @@ class IRPolisher {
 
   llvm::Value *mapIntrinsicCall(llvm::IRBuilder<>&, llvm::CallInst*, unsigned);
   llvm::Value *lowerIntrinsicCall(llvm::CallInst*);
+  bool lowerIntrinsicCalls();
 
   llvm::Value *replaceCmpInst(llvm::IRBuilder<>&, llvm::CmpInst*, unsigned);
   llvm::Value *replaceSelectInst(llvm::IRBuilder<>&, llvm::SelectInst*, unsigned);
@@ -25,6 +25,10 @@ llvm::Instruction& CreateReductInst(llvm::IRBuilder<> & builder, RedKind redKind
 // reduce the vector @vectorVal to a scalar value (using redKind)
 llvm::Value & CreateVectorReduce(Config & config, llvm::IRBuilder<> & builder, RedKind redKind, llvm::Value & vectorVal, llvm::Value * initVal);
 
+// inclusive prefix scan of the vector @vectorVal (lane i holds the reduction of lanes 0 to i)
+// uses log2(vectorWidth) shift-and-combine steps
+llvm::Value & CreateVectorScan(llvm::IRBuilder<> & builder, RedKind redKind, llvm::Value & vectorVal);
+
 // if laneOffset is >= 0 create an extract from that offset, if laneOffset < 0 add the vector width first
 // will return @vecVal if it is not a vector (uniform value)
 llvm::Value & CreateExtract(llvm::IRBuilder<> & builder, llvm::Value & vecVal, int laneOffset);
@@ -21,6 +21,7 @@ namespace llvm {
   class DominatorTree;
   class PostDominatorTree;
   class BranchProbabilityInfo;
+  class ScalarEvolution;
 }
 
 
@@ -40,6 +41,7 @@ class RemainderTransform {
   llvm::LoopInfo & LI;
   ReductionAnalysis & reda;
   llvm::BranchProbabilityInfo * PB;
+  llvm::ScalarEvolution * SE; // proves loads dereferenceable for all iterations (early exits)
 
 
 // RemainderTransform capability checks
@@ -49,19 +51,32 @@ class RemainderTransform {
   // if this returns true RemainderTransform must not fail during the transformation and has to return a vectorizable loop
   bool canTransformLoop(llvm::Loop & L);
 
+  // whether the scalar loop can replay vector iterations that take an early exit of @L (exits other than the latch)
+  bool canReplayEarlyExits(llvm::Loop & L);
+
+  // whether the remainder iterations of @L can run as a masked vector iteration of the vector loop
+  bool canFoldTail(llvm::Loop & L, BranchCondition & branchCond);
+
+  // collect the pointers of contiguous accesses in @L whose footprint stays within their underlying object for all (rounded up) vector iterations
+  void collectDereferenceableAccesses(llvm::Loop & L, int vectorWidth, ValueSet & derefAccesses);
+
 public:
-  RemainderTransform(llvm::Function &_F, llvm::DominatorTree & _DT, llvm::PostDominatorTree & _PDT, llvm::LoopInfo & _LI, ReductionAnalysis & _reda, llvm::BranchProbabilityInfo * _PB = nullptr)
+  RemainderTransform(llvm::Function &_F, llvm::DominatorTree & _DT, llvm::PostDominatorTree & _PDT, llvm::LoopInfo & _LI, ReductionAnalysis & _reda, llvm::BranchProbabilityInfo * _PB = nullptr, llvm::ScalarEvolution * _SE = nullptr)
   : F(_F)
   , DT(_DT)
   , PDT(_PDT)
   , LI(_LI)
   , reda(_reda)
   , PB(_PB)
+  , SE(_SE)
   {}
 
   // create a vectorizable loop or return nullptr if remTrans can not currently do it
+  // the vector loop is only entered if at least max(@vectorWidth, @minTripCount) iterations remain
+  // if @foldTail is set (and the loop permits it) the vector loop masks off the lanes past the trip count and no remainder iterations remain
+  // @derefAccesses receives the access pointers of the vector loop that are dereferenceable for the full vector width
   llvm::Loop*
-  createVectorizableLoop(llvm::Loop & L, ValueSet & uniOverrides, int vectorWidth, int tripAlign);
+  createVectorizableLoop(llvm::Loop & L, ValueSet & uniOverrides, ValueSet & derefAccesses, int vectorWidth, int tripAlign, int minTripCount = 0, bool foldTail = false);
 };
 
 }
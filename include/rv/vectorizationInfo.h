@@ -59,6 +59,12 @@ class VectorizationInfo {
   // whether the block will receive a non-uniform predicate
   std::map<const llvm::BasicBlock *, bool> VaryingPredicateBlocks;
 
+  // expected fraction of active lanes in the block predicate (estimated before linearization)
+  std::map<const llvm::BasicBlock *, double> LaneDensities;
+
+  // contiguous access pointers whose vector footprint is dereferenceable in every vector iteration (proven on the scalar loop)
+  std::set<const llvm::Value *> DereferenceableAccesses;
+
   // fixed shapes (will be preserved through VA)
   std::set<const llvm::Value *> pinned;
 
@@ -138,6 +144,14 @@ public:
   void setVaryingPredicateFlag(const llvm::BasicBlock &, bool toVarying);
   void removeVaryingPredicateFlag(const llvm::BasicBlock &);
 
+  // expected fraction of active lanes in the predicate of @BB (1.0 if unknown)
+  double getLaneDensity(const llvm::BasicBlock &BB) const;
+  void setLaneDensity(const llvm::BasicBlock &BB, double density);
+
+  // whether the vector access through @ptr is known to be dereferenceable (see RemainderTransform::createVectorizableLoop)
+  bool isDereferenceableAccess(const llvm::Value &ptr) const;
+  void addDereferenceableAccess(const llvm::Value &ptr);
+
   // actual basic block predicates
   llvm::Value *getPredicate(const llvm::BasicBlock &block) const;
   void setPredicate(const llvm::BasicBlock &block, llvm::Value &predicate);
@@ -133,22 +133,38 @@ PlatformInfo::getResolver(StringRef funcName,
                           FunctionType & scaFuncTy,
                           const VectorShapeVec & argShapes,
                           int vectorWidth,
-                          bool hasPredicate) const {
+                          bool hasPredicate,
+                          int maxULPError) const {
   IF_DEBUG_PLAT {
     errs() << "Resolver query:\n"
            << "scaName:  " << funcName << "\n"
            << "width:    " << vectorWidth << "\n"
            << "pred:     " << hasPredicate << "\n"
+           << "ulp:      " << maxULPError << "\n"
            << "argShapes:";
     for (auto argShape : argShapes) errs() << ", " << argShape.str();
     errs() << "\n";
   }
 
+  // pick the cheapest implementation (the earlier resolver wins ties)
+  std::unique_ptr<FunctionResolver> bestResolver = nullptr;
+  size_t bestCost = 0;
   for (const auto & resolver : resolverServices) {
-    std::unique_ptr<FunctionResolver> funcResolver = resolver->resolve(funcName, scaFuncTy, argShapes, vectorWidth, hasPredicate, mod);
-    if (funcResolver) return funcResolver;
+    // do not materialize candidates that can not beat the best one
+    if (bestResolver && resolver->getCostLowerBound().cost >= bestCost) continue;
+
+    std::unique_ptr<FunctionResolver> funcResolver = resolver->resolve(funcName, scaFuncTy, argShapes, vectorWidth, hasPredicate, maxULPError, mod);
+    if (!funcResolver) continue;
+
+    size_t cost = funcResolver->requestCostEstimate().cost;
+    if (!bestResolver || cost < bestCost) {
+      bestResolver = std::move(funcResolver);
+      bestCost = cost;
+    }
+    // nothing is cheaper than calling an existing vector function
+    if (bestCost <= 1) break;
   }
-  return nullptr;
+  return bestResolver;
 }
 
 llvm::Function &
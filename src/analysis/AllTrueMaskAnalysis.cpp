@@ -0,0 +1,154 @@
+//===- src/analysis/AllTrueMaskAnalysis.cpp - all-threads-live analysis --*- C++ -*-===//
+//
+// Part of the RV Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "rv/analysis/AllTrueMaskAnalysis.h"
+#include "rv/analysis/UndeadMaskAnalysis.h"
+
+#include <llvm/IR/PatternMatch.h>
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Constants.h>
+#include "rv/region/Region.h"
+#include "rv/vectorizationInfo.h"
+#include "rv/rvDebug.h"
+
+#include "rv/intrinsics.h"
+#include "rvConfig.h"
+
+using namespace llvm;
+
+#if 1
+#define IF_DEBUG_ATM IF_DEBUG
+#else
+#define IF_DEBUG_ATM if (true)
+#endif
+
+using namespace llvm::PatternMatch;
+
+namespace rv {
+
+static bool
+IsTrueMask(const Value & val) {
+  auto * constMask = dyn_cast<ConstantInt>(&val);
+  return constMask && constMask->isOne();
+}
+
+static bool
+IsNegationOf(const Value & val, const Value & negated) {
+  return match(&val, m_Not(m_Specific(&negated)));
+}
+
+AllTrueMaskAnalysis::AllTrueMaskAnalysis(VectorizationInfo & VecInfo, UndeadMaskAnalysis & UndeadMasks, FunctionAnalysisManager &FAM)
+: vecInfo(VecInfo)
+, undeadMasks(UndeadMasks)
+, domTree(FAM.getResult<DominatorTreeAnalysis>(vecInfo.getScalarFunction()))
+{}
+
+bool
+AllTrueMaskAnalysis::isComplementary(const Value & lhs, const Value & rhs, const BasicBlock & where) {
+  // p || !p
+  if (IsNegationOf(lhs, rhs) || IsNegationOf(rhs, lhs)) return true;
+
+  // (m && p) || (m && !p), m all-true
+  Value *lhsA, *lhsB, *rhsA, *rhsB;
+  if (!match(&lhs, m_And(m_Value(lhsA), m_Value(lhsB))) ||
+      !match(&rhs, m_And(m_Value(rhsA), m_Value(rhsB)))) {
+    return false;
+  }
+
+  const std::pair<Value*, Value*> lhsOrder[] = {{lhsA, lhsB}, {lhsB, lhsA}};
+  const std::pair<Value*, Value*> rhsOrder[] = {{rhsA, rhsB}, {rhsB, rhsA}};
+  for (const auto & lhsTerms : lhsOrder) {
+    for (const auto & rhsTerms : rhsOrder) {
+      if (lhsTerms.first != rhsTerms.first) continue;
+      if (!IsNegationOf(*lhsTerms.second, *rhsTerms.second) && !IsNegationOf(*rhsTerms.second, *lhsTerms.second)) continue;
+      if (isAllTrue(*lhsTerms.first, where)) return true;
+    }
+  }
+  return false;
+}
+
+bool
+AllTrueMaskAnalysis::isGuardedByAll(const Value & mask, const BasicBlock & where) {
+  auto * domNode = domTree.getNode(const_cast<BasicBlock*>(&where));
+  while (domNode) {
+    const auto * block = domNode->getBlock();
+    if (!vecInfo.getRegion().contains(block)) return false;
+
+    // the block is only entered on the true edge of an rv_all
+    const auto * predBlock = block->getSinglePredecessor();
+    const auto * predBranch = predBlock ? dyn_cast<BranchInst>(predBlock->getTerminator()) : nullptr;
+    if (predBranch && predBranch->isConditional() && predBranch->getSuccessor(0) == block && predBranch->getSuccessor(1) != block &&
+        GetIntrinsicID(*predBranch->getCondition()) == RVIntrinsic::All) {
+      // rv_all(q) only tests the active lanes of the guarding block
+      const auto & allArg = *cast<CallInst>(predBranch->getCondition())->getArgOperand(0);
+      const auto * guardMask = vecInfo.getPredicate(*predBlock);
+      if ((!guardMask || isAllTrue(*guardMask, *predBlock)) &&
+          UndeadMaskAnalysis::implies(allArg, false, mask, false)) {
+        IF_DEBUG_ATM { errs() << "ATM:\t guarded by rv_all in " << predBlock->getName() << "\n"; }
+        return true;
+      }
+    }
+
+    domNode = domNode->getIDom();
+  }
+  return false;
+}
+
+bool
+AllTrueMaskAnalysis::computeAllTrue(const Value & mask, const BasicBlock & where) {
+  // uniform masks are all-true if at least one lane is live
+  if (vecInfo.hasKnownShape(mask) && vecInfo.getVectorShape(mask).isUniform() && undeadMasks.isUndead(mask, where)) return true;
+
+  // conjunctions
+  Value *A, *B, *C;
+  if (match(&mask, m_And(m_Value(A), m_Value(B)))) {
+    return isAllTrue(*A, where) && isAllTrue(*B, where);
+  }
+
+  // disjunctions
+  if (match(&mask, m_Or(m_Value(A), m_Value(B)))) {
+    return isAllTrue(*A, where) || isAllTrue(*B, where) || isComplementary(*A, *B, where);
+  }
+
+  // blended masks (select(c, a, b) with c or both a and b all-true)
+  if (match(&mask, m_Select(m_Value(C), m_Value(A), m_Value(B)))) {
+    if (isAllTrue(*A, where) && (isAllTrue(*B, where) || isAllTrue(*C, where))) return true;
+  }
+
+  // join phis (all incoming masks are all-true on their edges)
+  if (auto * phi = dyn_cast<PHINode>(&mask)) {
+    if (!vecInfo.inRegion(*phi)) return false;
+    for (unsigned i = 0; i < phi->getNumIncomingValues(); ++i) {
+      if (!isAllTrue(*phi->getIncomingValue(i), *phi->getIncomingBlock(i))) return false;
+    }
+    return true;
+  }
+
+  return isGuardedByAll(mask, where);
+}
+
+bool
+AllTrueMaskAnalysis::isAllTrue(const Value & mask, const BasicBlock & where) {
+  if (IsTrueMask(mask)) return true;
+  if (isa<Constant>(mask)) return false;
+
+  auto key = std::make_pair(&mask, &where);
+  auto it = allTrueCache.find(key);
+  if (it != allTrueCache.end()) return it->second;
+
+  // (conservatively) break cycles
+  if (!pendingMasks.insert(&mask).second) return false;
+  bool allTrue = computeAllTrue(mask, where);
+  pendingMasks.erase(&mask);
+
+  IF_DEBUG_ATM { errs() << "ATM: " << mask.getName() << " at " << where.getName() << (allTrue ? " is all-true\n" : " may be partial\n"); }
+  allTrueCache[key] = allTrue;
+  return allTrue;
+}
+
+} // namespace rv
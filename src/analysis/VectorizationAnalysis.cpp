@@ -8,6 +8,7 @@
 
 #include "rv/analysis/VectorizationAnalysis.h"
 #include "rv/intrinsics.h"
+#include "rv/annotations.h"
 #include "rv/shape/vectorShapeTransformer.h"
 
 #include "rv/analysis/AllocaSSA.h"
@@ -374,6 +375,8 @@ void VectorizationAnalysis::compute(const Function &F) {
     if (I.getType()->isPointerTy()) {
       // adjust result type to match alignment
       unsigned minAlignment = I.getPointerAlignment(layout).valueOrOne().value();
+      // the first lane is aligned (alignment peeling)
+      if (New.hasStridedShape()) minAlignment = std::max<unsigned>(minAlignment, ReadAlignmentHint(I));
       New.setAlignment(
           std::max<unsigned>(minAlignment, New.getAlignmentFirst()));
     } else if (isa<FPMathOperator>(I) && !isa<CallInst>(I)) {
@@ -15,15 +15,18 @@
 #include "rv/config.h"
 
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/IntrinsicInst.h"
 #include "llvm/IR/BasicBlock.h"
 #include "llvm/IR/DerivedTypes.h"
 #include "llvm/IR/Intrinsics.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/Analysis/VectorUtils.h"
 
 #include "rv/utils.h"
 
 using namespace llvm;
 
-#define IF_DEBUG_CM if (true)
+#define IF_DEBUG_CM if (false)
 
 namespace rv {
 
@@ -40,17 +43,6 @@ CostModel::needsReplication(const Instruction & inst) const {
   return true; // TODO query vecInfo
 }
 
-static
-size_t
-CountDataPhis(const BasicBlock & block) {
-  size_t t = 0;
-  for (auto & inst : block) {
-    if (!isa<PHINode>(inst)) continue;
-    t += (size_t) inst.getType()->isFloatingPointTy();
-  }
-  return t;
-}
-
 size_t
 CostModel::pickWidthForMapping(const VectorMapping & mapping) const {
   if (mapping.vectorFn) return mapping.vectorWidth;
@@ -168,22 +160,13 @@ CostModel::pickWidthForType(const Type & type, size_t maxWidth) const {
 
 size_t
 CostModel::pickWidthForBlock(const BasicBlock & block, size_t maxWidth) const {
+  // only bounds the width (available implementations, types), profitability is up to the TTI costs in pickCheapestWidth
   for (const auto & inst : block) maxWidth = pickWidthForInstruction(inst, maxWidth);
-  size_t numDataPhis = CountDataPhis(block);
-
-  if (numDataPhis > 2*maxWidth) {
-    // do not vectorize if too many values are in flight
-    // FIXME this is a crude method to estimate the hazard of being surpassed by plain SLP vectorization
-    // this assumes that the number of data-bearing (as compared to address computation, control slice) phi nodes correlates with instruction level parallelism.
-    // Hence, it might be sensible to relay on SLP vectorization instead of turning each one of them into a vector PHI.
-    return 1;
-  }
-
   return maxWidth;
 }
 
 size_t
-CostModel::pickWidthForRegion(const Region & region, size_t maxWidth) const {
+CostModel::boundWidthForRegion(const Region & region, size_t maxWidth) const {
   size_t width = std::min(maxWidth, platInfo.getMaxVectorBits());
 
   IF_DEBUG_CM { errs() << "cm: bounding vector width for region " << region.str() << ", initial max width " << width << "\n"; }
@@ -196,5 +179,441 @@ CostModel::pickWidthForRegion(const Region & region, size_t maxWidth) const {
   return width;
 }
 
+size_t
+CostModel::pickCheapestWidth(size_t maxWidth, std::function<int64_t(size_t)> regionCost) const {
+  if (maxWidth <= 1) return 1;
+
+  // pick the width with the lowest cost per scalar iteration (the scalar loop competes as width 1)
+  size_t bestWidth = 1;
+  int64_t bestCost = regionCost(1);
+  IF_DEBUG_CM { errs() << "cm: scalar cost " << bestCost << "\n"; }
+
+  for (size_t candWidth = 2; candWidth <= maxWidth; candWidth *= 2) {
+    int64_t candCost = regionCost(candWidth);
+    IF_DEBUG_CM { errs() << "cm: cost at width " << candWidth << " is " << candCost << " (" << (candCost / (double) candWidth) << " per scalar iteration)\n"; }
+
+    // candCost / candWidth < bestCost / bestWidth
+    if (candCost * (int64_t) bestWidth < bestCost * (int64_t) candWidth) {
+      bestWidth = candWidth;
+      bestCost = candCost;
+    }
+  }
+
+  return bestWidth;
+}
+
+size_t
+CostModel::pickWidthForRegion(const Region & region, size_t maxWidth) const {
+  size_t width = boundWidthForRegion(region, maxWidth);
+  return pickCheapestWidth(width, [&](size_t candWidth) {
+    return getRegionCost(region, candWidth);
+  });
+}
+
+size_t
+CostModel::pickWidthForRegion(Region & region, size_t maxWidth, ShapeAnalysis analyzeShapes) const {
+  size_t width = boundWidthForRegion(region, maxWidth);
+  return pickCheapestWidth(width, [&](size_t candWidth) {
+    if (candWidth <= 1) return getRegionCost(region, 1);
+
+    // speculatively run the shape analysis at this width
+    VectorizationInfo vecInfo(region.getFunction(), candWidth, region);
+    if (!analyzeShapes(vecInfo)) {
+      IF_DEBUG_CM { errs() << "cm: no shapes at width " << candWidth << ", falling back to shape guesses\n"; }
+      return getRegionCost(region, candWidth);
+    }
+    return getRegionCost(region, candWidth, &vecInfo);
+  });
+}
+
+static
+Type*
+GetVectorType(Type & scaTy, size_t vectorWidth) {
+  if (!VectorType::isValidElementType(&scaTy)) return nullptr;
+  return FixedVectorType::get(&scaTy, vectorWidth);
+}
+
+VectorShape
+CostModel::guessShape(const Value & val, const Region & region) const {
+  auto * inst = dyn_cast<Instruction>(&val);
+  if (!inst || !region.contains(inst->getParent())) return VectorShape::uni();
+
+  // the vectorized loop counter (and its casts)
+  auto * phi = dyn_cast<PHINode>(inst);
+  if (phi) {
+    if (region.isVectorLoop() && phi->getParent() == &region.getRegionEntry() && phi->getType()->isIntegerTy()) {
+      return VectorShape::cont();
+    }
+    return VectorShape::varying();
+  }
+  if (isa<SExtInst>(inst) || isa<ZExtInst>(inst)) {
+    return guessShape(*inst->getOperand(0), region);
+  }
+
+  // consecutive addresses (uniform base, uniform leading indices, contiguous last index)
+  auto * gep = dyn_cast<GetElementPtrInst>(inst);
+  if (!gep) return VectorShape::varying();
+
+  if (!guessShape(*gep->getPointerOperand(), region).isUniform()) return VectorShape::varying();
+  for (unsigned i = 1; i + 1 < gep->getNumOperands(); ++i) {
+    if (!guessShape(*gep->getOperand(i), region).isUniform()) return VectorShape::varying();
+  }
+  auto lastShape = guessShape(*gep->getOperand(gep->getNumOperands() - 1), region);
+  if (lastShape.isUniform()) return lastShape;
+  if (lastShape.isContiguous()) {
+    // byte stride of the accessed element type
+    size_t elemBytes = platInfo.getDataLayout().getTypeStoreSize(gep->getResultElementType());
+    return VectorShape::strided(elemBytes);
+  }
+  return VectorShape::varying();
+}
+
+VectorShape
+CostModel::getShape(const Value & val, const Region & region, const VectorizationInfo * vecInfo) const {
+  if (vecInfo && vecInfo->hasKnownShape(val)) return vecInfo->getVectorShape(val);
+  return guessShape(val, region);
+}
+
+bool
+CostModel::isPredicated(const BasicBlock & block, const Region & region, const VectorizationInfo * vecInfo) const {
+  bool varyingPred;
+  if (vecInfo && vecInfo->getVaryingPredicateFlag(block, varyingPred)) return varyingPred;
+
+  // without divergence information assume that every conditionally executed block is masked
+  if (&block == &region.getRegionEntry()) return false;
+  auto * singlePred = block.getSinglePredecessor();
+  if (!singlePred || !region.contains(singlePred)) return false;
+  auto * branch = dyn_cast<BranchInst>(singlePred->getTerminator());
+  return branch && branch->isConditional();
+}
+
+int
+CostModel::getScalarizationCost(Type & type, size_t vectorWidth, bool insert, bool extract) const {
+  auto * vecTy = GetVectorType(type, vectorWidth);
+  if (!vecTy) return 0; // aggregates are replicated lane-wise anyway
+
+  int cost = 0;
+  for (size_t i = 0; i < vectorWidth; ++i) {
+    if (insert) cost += tti.getVectorInstrCost(Instruction::InsertElement, vecTy, i);
+    if (extract) cost += tti.getVectorInstrCost(Instruction::ExtractElement, vecTy, i);
+  }
+  return cost;
+}
+
+int
+CostModel::getReplicationCost(const Instruction & inst, size_t vectorWidth, bool cascaded, const Region & region, const VectorizationInfo * vecInfo) const {
+  int cost = vectorWidth * getScalarCost(inst);
+
+  // extract the operands of every lane (uniform operands are used as they are)..
+  for (const auto & op : inst.operands()) {
+    if (isa<Constant>(op.get()) || isa<BasicBlock>(op.get())) continue;
+    if (getShape(*op.get(), region, vecInfo).isUniform()) continue;
+    cost += getScalarizationCost(*op->getType(), vectorWidth, false, true);
+  }
+
+  // ..and re-assemble the result
+  if (!inst.getType()->isVoidTy()) {
+    cost += getScalarizationCost(*inst.getType(), vectorWidth, true, false);
+  }
+
+  // cascades test each mask bit and branch around inactive lanes
+  if (cascaded) {
+    auto & boolTy = *Type::getInt1Ty(inst.getContext());
+    cost += getScalarizationCost(boolTy, vectorWidth, false, true);
+    cost += vectorWidth * tti.getCFInstrCost(Instruction::Br, TargetTransformInfo::TCK_RecipThroughput);
+  }
+  return cost;
+}
+
+int
+CostModel::getMemoryCost(const Instruction & inst, size_t vectorWidth, const Region & region, const VectorizationInfo * vecInfo) const {
+  auto * load = dyn_cast<LoadInst>(&inst);
+  auto * store = dyn_cast<StoreInst>(&inst);
+  assert((load || store) && "not a memory instruction");
+
+  const Value & ptr = load ? *load->getPointerOperand() : *store->getPointerOperand();
+  Type & dataTy = load ? *load->getType() : *store->getValueOperand()->getType();
+  llvm::Align alignment = load ? load->getAlign() : store->getAlign();
+  unsigned addrSpace = ptr.getType()->getPointerAddressSpace();
+  unsigned opcode = inst.getOpcode();
+  const bool masked = isPredicated(*inst.getParent(), region, vecInfo);
+
+  auto addrShape = getShape(ptr, region, vecInfo);
+
+  // uniform access (broadcast the loaded value or store the last lane)
+  if (addrShape.isUniform()) {
+    int cost = getScalarCost(inst);
+    auto * vecTy = GetVectorType(dataTy, vectorWidth);
+    if (load && vecTy) {
+      cost += tti.getShuffleCost(TargetTransformInfo::SK_Broadcast, cast<VectorType>(vecTy));
+    } else if (store && vecTy && !getShape(*store->getValueOperand(), region, vecInfo).isUniform()) {
+      cost += tti.getVectorInstrCost(Instruction::ExtractElement, vecTy, vectorWidth - 1);
+    }
+    return cost;
+  }
+
+  auto * vecTy = GetVectorType(dataTy, vectorWidth);
+  if (!vecTy) return getReplicationCost(inst, vectorWidth, masked, region, vecInfo);
+
+  // wide (masked) load/store
+  size_t byteSize = platInfo.getDataLayout().getTypeStoreSize(&dataTy);
+  if (addrShape.isStrided(byteSize)) {
+    if (masked) {
+      return tti.getMaskedMemoryOpCost(opcode, vecTy, alignment, addrSpace, TargetTransformInfo::TCK_RecipThroughput);
+    }
+    return tti.getMemoryOpCost(opcode, vecTy, alignment, addrSpace, TargetTransformInfo::TCK_RecipThroughput);
+  }
+
+  // reverse wide (masked) load/store (the data and the mask are shuffled)
+  if (addrShape.isStrided(-(int) byteSize)) {
+    int cost = tti.getShuffleCost(TargetTransformInfo::SK_Reverse, cast<VectorType>(vecTy));
+    if (masked) {
+      return cost * 2 + tti.getMaskedMemoryOpCost(opcode, vecTy, alignment, addrSpace, TargetTransformInfo::TCK_RecipThroughput);
+    }
+    return cost + tti.getMemoryOpCost(opcode, vecTy, alignment, addrSpace, TargetTransformInfo::TCK_RecipThroughput);
+  }
+
+  // gather/scatter intrinsics (if enabled) or a cascade of scalar accesses
+  if (config.useScatterGatherIntrinsics && tti.isLegalMaskedGather(vecTy, alignment)) {
+    return tti.getGatherScatterOpCost(opcode, vecTy, &ptr, masked, alignment, TargetTransformInfo::TCK_RecipThroughput);
+  }
+  int replCost = getReplicationCost(inst, vectorWidth, masked, region, vecInfo);
+
+  // unmasked gather/scatter with the inactive lanes pointing to a scratch slot (address blend + native access)
+  if (masked && config.useSafeAddressGather) {
+    int safeCost = tti.getGatherScatterOpCost(opcode, vecTy, &ptr, false, alignment, TargetTransformInfo::TCK_RecipThroughput);
+    safeCost += tti.getCmpSelInstrCost(Instruction::Select, GetVectorType(*ptr.getType(), vectorWidth), nullptr, TargetTransformInfo::TCK_RecipThroughput);
+    return std::min(safeCost, replCost);
+  }
+  return replCost;
+}
+
+int
+CostModel::getCallCost(const CallInst & call, size_t vectorWidth, const Region & region, const VectorizationInfo * vecInfo) const {
+  auto * callee = call.getCalledFunction();
+  const bool masked = isPredicated(*call.getParent(), region, vecInfo);
+  if (!callee) return getReplicationCost(call, vectorWidth, masked, region, vecInfo);
+
+  // lifetime markers et al.
+  if (IsVectorizableFunction(*callee)) return 0;
+
+  // widened argument and return types
+  SmallVector<Type*, 4> vecArgTys;
+  for (const auto & arg : call.arg_operands()) {
+    auto * argVecTy = GetVectorType(*arg->getType(), vectorWidth);
+    vecArgTys.push_back(argVecTy ? argVecTy : arg->getType());
+  }
+  Type * vecRetTy = call.getType();
+  if (!vecRetTy->isVoidTy()) {
+    vecRetTy = GetVectorType(*call.getType(), vectorWidth);
+    if (!vecRetTy) return getReplicationCost(call, vectorWidth, masked, region, vecInfo);
+  }
+
+  // LLVM intrinsics with a native vector equivalent
+  Intrinsic::ID id = callee->getIntrinsicID();
+  if (id != Intrinsic::not_intrinsic && isTriviallyVectorizable(id)) {
+    IntrinsicCostAttributes costAttrs(id, vecRetTy, vecArgTys);
+    return tti.getIntrinsicInstrCost(costAttrs, TargetTransformInfo::TCK_RecipThroughput);
+  }
+
+  // critical sections and recursive vectorization produce a single call
+  bool hasVectorImpl = IsCriticalSection(*callee) || (!callee->isDeclaration() && config.enableGreedyIPV);
+
+  // vector implementation by a resolver (eg SLEEF)
+  if (!hasVectorImpl) {
+    VectorShapeVec argShapes;
+    for (const auto & arg : call.arg_operands()) {
+      argShapes.push_back(vecInfo ? getShape(*arg.get(), region, vecInfo) : VectorShape::varying());
+    }
+    hasVectorImpl = (bool) platInfo.getResolver(callee->getName(), *callee->getFunctionType(), argShapes, vectorWidth, masked);
+  }
+
+  if (hasVectorImpl) {
+    return tti.getCallInstrCost(nullptr, vecRetTy, vecArgTys, TargetTransformInfo::TCK_RecipThroughput);
+  }
+
+  // otw, NatBuilder will replicate the call per lane
+  return getReplicationCost(call, vectorWidth, masked, region, vecInfo);
+}
+
+int
+CostModel::getScalarCost(const Instruction & inst) const {
+  // free or folded instructions
+  if (isa<PHINode>(inst) || isa<DbgInfoIntrinsic>(inst)) return 0;
+
+  int cost = tti.getInstructionCost(&inst, TargetTransformInfo::TCK_RecipThroughput);
+  return cost < 0 ? 1 : cost; // unknown cost
+}
+
+int
+CostModel::getVectorCost(const Instruction & inst, size_t vectorWidth, const Region & region, const VectorizationInfo * vecInfo) const {
+  if (vectorWidth <= 1) return getScalarCost(inst);
+  if (isa<DbgInfoIntrinsic>(inst)) return 0;
+
+  // uniform computations execute once per vector iteration
+  if (vecInfo && !inst.getType()->isVoidTy() && !inst.mayHaveSideEffects() &&
+      getShape(inst, region, vecInfo).isUniform()) {
+    return getScalarCost(inst);
+  }
+
+  // control flow is linearized, divergent join points become blends
+  if (inst.isTerminator()) return getScalarCost(inst);
+  if (auto * phi = dyn_cast<PHINode>(&inst)) {
+    if (phi->getParent() == &region.getRegionEntry()) return 0; // loop-carried values
+    if (vecInfo && !vecInfo->isJoinDivergent(*phi->getParent())) return 0;
+    auto * vecTy = GetVectorType(*phi->getType(), vectorWidth);
+    if (!vecTy) return 0;
+    auto * maskTy = FixedVectorType::get(Type::getInt1Ty(inst.getContext()), vectorWidth);
+    return (phi->getNumIncomingValues() - 1) * tti.getCmpSelInstrCost(Instruction::Select, vecTy, maskTy);
+  }
+
+  if (isa<LoadInst>(inst) || isa<StoreInst>(inst)) return getMemoryCost(inst, vectorWidth, region, vecInfo);
+  if (auto * call = dyn_cast<CallInst>(&inst)) return getCallCost(*call, vectorWidth, region, vecInfo);
+
+  // address computation
+  if (auto * gep = dyn_cast<GetElementPtrInst>(&inst)) {
+    auto gepShape = getShape(*gep, region, vecInfo);
+    if (gepShape.hasStridedShape()) return getScalarCost(inst); // folds into the wide access
+    auto & intPtrTy = *platInfo.getDataLayout().getIntPtrType(gep->getType());
+    auto * vecIntTy = GetVectorType(intPtrTy, vectorWidth);
+    return (gep->getNumIndices()) * (tti.getArithmeticInstrCost(Instruction::Add, vecIntTy) +
+                                     tti.getArithmeticInstrCost(Instruction::Mul, vecIntTy));
+  }
+
+  auto * vecTy = inst.getType()->isVoidTy() ? nullptr : GetVectorType(*inst.getType(), vectorWidth);
+  if (!vecTy) return getReplicationCost(inst, vectorWidth, false, region, vecInfo);
+
+  if (inst.isBinaryOp() || isa<UnaryOperator>(inst)) {
+    return tti.getArithmeticInstrCost(inst.getOpcode(), vecTy);
+  }
+
+  if (isa<CmpInst>(inst) || isa<SelectInst>(inst)) {
+    auto & valTy = isa<CmpInst>(inst) ? *inst.getOperand(0)->getType() : *inst.getType();
+    auto * vecValTy = GetVectorType(valTy, vectorWidth);
+    auto * maskTy = FixedVectorType::get(Type::getInt1Ty(inst.getContext()), vectorWidth);
+    if (!vecValTy) return getReplicationCost(inst, vectorWidth, false, region, vecInfo);
+    return tti.getCmpSelInstrCost(inst.getOpcode(), vecValTy, maskTy);
+  }
+
+  if (auto * castInst = dyn_cast<CastInst>(&inst)) {
+    auto * vecSrcTy = GetVectorType(*castInst->getSrcTy(), vectorWidth);
+    if (!vecSrcTy) return getReplicationCost(inst, vectorWidth, false, region, vecInfo);
+    return tti.getCastInstrCost(inst.getOpcode(), vecTy, vecSrcTy, TargetTransformInfo::TCK_RecipThroughput);
+  }
+
+  // anything else is replicated
+  return getReplicationCost(inst, vectorWidth, false, region, vecInfo);
+}
+
+int
+CostModel::getRegionCost(const Region & region, size_t vectorWidth, const VectorizationInfo * vecInfo) const {
+  int cost = 0;
+  region.for_blocks([&](const BasicBlock & block) {
+    for (const auto & inst : block) {
+      cost += vectorWidth > 1 ? getVectorCost(inst, vectorWidth, region, vecInfo) : getScalarCost(inst);
+    }
+    return true;
+  });
+  return cost;
+}
+
+int
+CostModel::getLoopOverheadCost(const Region & region, size_t vectorWidth, const VectorizationInfo * vecInfo) const {
+  if (vectorWidth <= 1 || !region.isVectorLoop()) return 0;
+
+  int cost = 0;
+  auto & header = region.getRegionEntry();
+  for (auto & inst : header) {
+    auto * phi = dyn_cast<PHINode>(&inst);
+    if (!phi) break;
+
+    auto * vecTy = GetVectorType(*phi->getType(), vectorWidth);
+    if (!vecTy) continue;
+    auto phiShape = getShape(*phi, region, vecInfo);
+    if (phiShape.isUniform()) continue;
+
+    // broadcast the initial value
+    cost += tti.getShuffleCost(TargetTransformInfo::SK_Broadcast, cast<VectorType>(vecTy));
+
+    // add the lane offsets to induction variables
+    if (phiShape.hasStridedShape()) {
+      cost += tti.getArithmeticInstrCost(phi->getType()->isFloatingPointTy() ? Instruction::FAdd : Instruction::Add, vecTy);
+      continue;
+    }
+
+    // reduce privatized accumulators on exit
+    unsigned redOpcode = phi->getType()->isFloatingPointTy() ? Instruction::FAdd : Instruction::Add;
+    for (size_t i = 0; i < phi->getNumIncomingValues(); ++i) {
+      if (!region.contains(phi->getIncomingBlock(i))) continue;
+      auto * binOp = dyn_cast<BinaryOperator>(phi->getIncomingValue(i));
+      if (binOp) redOpcode = binOp->getOpcode();
+    }
+    cost += tti.getArithmeticReductionCost(redOpcode, cast<VectorType>(vecTy), false, TargetTransformInfo::TCK_RecipThroughput);
+  }
+  return cost;
+}
+
+size_t
+CostModel::pickInterleaveCount(Region & region, size_t vectorWidth, ShapeAnalysis analyzeShapes) const {
+  if (vectorWidth <= 1 || !region.isVectorLoop()) return 1;
+
+  VectorizationInfo vecInfo(region.getFunction(), vectorWidth, region);
+  const VectorizationInfo * shapeInfo = analyzeShapes(vecInfo) ? &vecInfo : nullptr;
+
+  // privatized accumulators (varying loop-carried values)
+  size_t numAccumulators = 0;
+  for (auto & inst : region.getRegionEntry()) {
+    auto * phi = dyn_cast<PHINode>(&inst);
+    if (!phi) break;
+    if (getShape(*phi, region, shapeInfo).isVarying()) ++numAccumulators;
+  }
+
+  // interleaving pays off by breaking up the latency chains of reductions
+  if (numAccumulators == 0) return 1;
+
+  // keep the accumulator and one operand of every interleaved iteration in registers
+  size_t numVectorRegs = tti.getNumberOfRegisters(tti.getRegisterClassForType(true));
+  size_t regsPerIteration = 2 * numAccumulators;
+  size_t interleaveCount = std::min<size_t>(tti.getMaxInterleaveFactor(vectorWidth), numVectorRegs / regsPerIteration);
+
+  // round down to a power of two
+  size_t powerOfTwo = 1;
+  while (2 * powerOfTwo <= interleaveCount) powerOfTwo *= 2;
+
+  IF_DEBUG_CM { errs() << "cm: interleave count " << powerOfTwo << " for " << numAccumulators << " accumulators at width " << vectorWidth << "\n"; }
+  return powerOfTwo;
+}
+
+size_t
+CostModel::getMinProfitableTripCount(Region & region, size_t vectorWidth, size_t baseWidth, ShapeAnalysis analyzeShapes) const {
+  assert(baseWidth < vectorWidth);
+
+  auto getCosts = [&](size_t width, int64_t & overhead) -> int64_t {
+    if (width <= 1) {
+      overhead = 0;
+      return getRegionCost(region, 1);
+    }
+    VectorizationInfo vecInfo(region.getFunction(), width, region);
+    const VectorizationInfo * shapeInfo = analyzeShapes(vecInfo) ? &vecInfo : nullptr;
+    overhead = getLoopOverheadCost(region, width, shapeInfo);
+    return getRegionCost(region, width, shapeInfo);
+  };
+
+  int64_t vecOverhead, baseOverhead;
+  int64_t vecCost = getCosts(vectorWidth, vecOverhead);
+  int64_t baseCost = getCosts(baseWidth, baseOverhead);
+
+  // gain of one wide iteration over (vectorWidth / baseWidth) base iterations (scaled by baseWidth)
+  int64_t gain = baseCost * vectorWidth - vecCost * baseWidth;
+  if (gain <= 0) return 0;
+
+  // number of wide iterations to amortize the additional overhead
+  int64_t extraOverhead = std::max<int64_t>(0, vecOverhead - baseOverhead) * baseWidth;
+  size_t numVecIters = extraOverhead / gain + 1;
+
+  IF_DEBUG_CM { errs() << "cm: width " << vectorWidth << " beats width " << baseWidth << " from " << (numVecIters * vectorWidth) << " iterations\n"; }
+  return numVecIters * vectorWidth;
+}
+
 
 }
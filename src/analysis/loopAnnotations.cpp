@@ -24,6 +24,7 @@ LoopMD::print(raw_ostream & out) const {
   if (vectorizeEnable.isSet()) out << "vectorizeEnable = " << vectorizeEnable.get() << ", ";
   if (minDepDist.isSet()) out << "minDepDist = " << DepDistToString(minDepDist.get()) << ", ";
   if (explicitVectorWidth.isSet()) out << "explicitVectorWidth = " << explicitVectorWidth.get() << ", ";
+  if (interleaveCount.isSet()) out << "interleaveCount = " << interleaveCount.get() << ", ";
   out << "}";
   return out;
 }
@@ -67,6 +68,11 @@ OptimisticJoin(LoopMD && A, LoopMD && B) {
     md.explicitVectorWidth = std::min<iter_t>(A.explicitVectorWidth.safeGet(ParallelDistance), B.explicitVectorWidth.safeGet(ParallelDistance));
   }
 
+  // use the smallest interleaveCount
+  if (A.interleaveCount.isSet() || B.interleaveCount.isSet()) {
+    md.interleaveCount = std::min<iter_t>(A.interleaveCount.safeGet(ParallelDistance), B.interleaveCount.safeGet(ParallelDistance));
+  }
+
   return md;
 }
 
@@ -116,6 +122,9 @@ GetLoopAnnotation(llvm::Loop & L) {
     } else if (text.equals("llvm.loop.vectorize.width")) {
       llvmAnnot.explicitVectorWidth = cast<ConstantInt>(Cst->getValue())->getSExtValue();
 
+    } else if (text.equals("llvm.loop.interleave.count")) {
+      llvmAnnot.interleaveCount = cast<ConstantInt>(Cst->getValue())->getSExtValue();
+
     } else if (text.equals("rv.loop.vectorize.enable")) {
       const bool vectorizeEnable = !Cst->getValue()->isNullValue();
       rvAnnot.vectorizeEnable = vectorizeEnable;
@@ -12,6 +12,7 @@
 #include <llvm/IR/Constants.h>
 #include <llvm/Support/raw_ostream.h>
 #include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/PatternMatch.h>
 
 #include "rvConfig.h"
 #include "rv/shape/vectorShape.h"
@@ -27,6 +28,39 @@ using namespace llvm;
 
 namespace rv {
 
+// whether NaNs and signed zeros can be ignored for the FP min/max select @inst
+// (only then does "select (fcmp a, b), a, b" agree with maxnum/minnum)
+static bool
+IgnoresNaNsAndSignedZeros(Instruction & inst) {
+  auto * sel = cast<SelectInst>(&inst);
+  auto * cmp = dyn_cast<FCmpInst>(sel->getCondition());
+  if (cmp && cmp->hasNoNaNs() && cmp->hasNoSignedZeros()) return true;
+  if (isa<FPMathOperator>(sel) && sel->hasNoNaNs() && sel->hasNoSignedZeros()) return true;
+
+  // -ffast-math et al.
+  auto & func = *inst.getFunction();
+  return func.getFnAttribute("no-nans-fp-math").getValueAsString() == "true" &&
+         func.getFnAttribute("no-signed-zeros-fp-math").getValueAsString() == "true";
+}
+
+// match "select (cmp a, b), a, b" min/max patterns (Bot otherwise)
+static RedKind
+MatchMinMaxSelect(Instruction & inst) {
+  using namespace PatternMatch;
+  Value * lhs, * rhs;
+  if (match(&inst, m_SMax(m_Value(lhs), m_Value(rhs)))) return RedKind::SMax;
+  if (match(&inst, m_UMax(m_Value(lhs), m_Value(rhs)))) return RedKind::UMax;
+  if (match(&inst, m_SMin(m_Value(lhs), m_Value(rhs)))) return RedKind::SMin;
+  if (match(&inst, m_UMin(m_Value(lhs), m_Value(rhs)))) return RedKind::UMin;
+
+  if (!IgnoresNaNsAndSignedZeros(inst)) return RedKind::Bot;
+  if (match(&inst, m_OrdFMax(m_Value(lhs), m_Value(rhs))) ||
+      match(&inst, m_UnordFMax(m_Value(lhs), m_Value(rhs)))) return RedKind::FMax;
+  if (match(&inst, m_OrdFMin(m_Value(lhs), m_Value(rhs))) ||
+      match(&inst, m_UnordFMin(m_Value(lhs), m_Value(rhs)))) return RedKind::FMin;
+  return RedKind::Bot;
+}
+
 // try to infer the reduction kind of the operator implemented by inst
 static RedKind
 InferRedKind(Instruction & inst, Reduction & red) {
@@ -56,8 +90,28 @@ InferRedKind(Instruction & inst, Reduction & red) {
     case Instruction::And:
       return RedKind::And;
 
-  // preserving operations
+    case Instruction::Xor:
+      return RedKind::Xor;
+
+    case Instruction::Call:
+      return InferCallRedKind(cast<CallInst>(inst));
+
+  // min/max selects (otw, preserving)
     case Instruction::Select:
+      return MatchMinMaxSelect(inst);
+
+  // the condition of min/max selects (may also select the index of an arg reduction)
+    case Instruction::ICmp:
+    case Instruction::FCmp: {
+      for (auto * user : inst.users()) {
+        auto * sel = dyn_cast<SelectInst>(user);
+        if (!sel || sel->getCondition() != &inst) return RedKind::Top;
+        if (red.contains(*sel) && MatchMinMaxSelect(*sel) == RedKind::Bot) return RedKind::Top;
+      }
+      return RedKind::Bot;
+    }
+
+  // preserving operations
     case Instruction::PHI:
       return RedKind::Bot;
 
@@ -76,6 +130,21 @@ StridePattern::print(raw_ostream & out) const {
 
 void StridePattern::dump() const { print(errs()); }
 
+Value &
+StridePattern::createOffset(IRBuilder<> & builder, Value & val, int64_t amount, const Twine & name) const {
+  if (!val.getType()->isPointerTy()) {
+    return *builder.CreateAdd(&val, ConstantInt::getSigned(val.getType(), amount), name);
+  }
+
+  // byte-wise pointer increment
+  auto & ctx = val.getContext();
+  auto * ptrTy = cast<PointerType>(val.getType());
+  auto * bytePtrTy = Type::getInt8PtrTy(ctx, ptrTy->getAddressSpace());
+  auto * bytePtr = builder.CreatePointerCast(&val, bytePtrTy);
+  auto * offsetPtr = builder.CreateGEP(Type::getInt8Ty(ctx), bytePtr, ConstantInt::getSigned(Type::getInt64Ty(ctx), amount));
+  return *builder.CreatePointerCast(offsetPtr, ptrTy, name);
+}
+
 
 
 // struct Reduction
@@ -86,6 +155,24 @@ Reduction::dump() const {
   print(errs());
 }
 
+bool
+Reduction::isScan() const {
+  if (!levelLoop) return false;
+
+  for (auto * elem : elements) {
+    for (auto * user : elem->users()) {
+      auto * userInst = dyn_cast<Instruction>(user);
+      if (!userInst || elements.count(userInst)) continue;
+      // index selects of arg reductions
+      bool argUser = false;
+      for (auto * argRed : argReds) argUser |= argRed->contains(*userInst);
+      if (argUser) continue;
+      if (levelLoop->contains(userInst->getParent())) return true;
+    }
+  }
+  return false;
+}
+
 void
 Reduction::print(raw_ostream & out) const {
   std::string loopName =
@@ -167,44 +254,66 @@ ReductionAnalysis::tryMatchStridePattern(PHINode & headerPhi) {
     return nullptr;
   }
 
-  // match opCode
-  auto oc = redInst->getOpcode();
-  int64_t sign = 0;
-  if (oc == Instruction::Add || oc == Instruction::FAdd) {
-    sign = 1;
-  } else if (oc == Instruction::Sub || oc == Instruction::FSub) {
-    sign = -1;
+  int64_t inc = 0;
+
+  // pointer induction "p.next = gep T, p, C" (stride in bytes)
+  if (auto * gep = dyn_cast<GetElementPtrInst>(redInst)) {
+    auto * idxConst = gep->getNumIndices() == 1 ? dyn_cast<ConstantInt>(gep->getOperand(1)) : nullptr;
+    if (!idxConst) {
+      REASON("pointer increment is not a constant offset")
+      return nullptr;
+    }
+    if (gep->getPointerOperand() != &headerPhi) {
+      REASON("pointer increment does not use phi node directly")
+      return nullptr;
+    }
+    const auto & layout = headerPhi.getModule()->getDataLayout();
+    inc = idxConst->getSExtValue() * (int64_t) layout.getTypeAllocSize(gep->getSourceElementType());
+
   } else {
-    REASON("unrecognized opcode")
-    return nullptr;
-  }
+    // match opCode
+    auto oc = redInst->getOpcode();
+    int64_t sign = 0;
+    if (oc == Instruction::Add || oc == Instruction::FAdd) {
+      sign = 1;
+    } else if (oc == Instruction::Sub || oc == Instruction::FSub) {
+      sign = -1;
+    } else {
+      REASON("unrecognized opcode")
+      return nullptr;
+    }
 
-// parse constant (oInc)
-  Constant* firstConst = dyn_cast<Constant>(redInst->getOperand(0));
-  Constant* secConst = dyn_cast<Constant>(redInst->getOperand(1));
+  // parse constant (oInc)
+    Constant* firstConst = dyn_cast<Constant>(redInst->getOperand(0));
+    Constant* secConst = dyn_cast<Constant>(redInst->getOperand(1));
 
-  // at least one op needs to be constant
-  if (!firstConst && !secConst) {
-    REASON("neither reductor operand is a constant")
-    return nullptr;
-  }
+    // at least one op needs to be constant
+    if (!firstConst && !secConst) {
+      REASON("neither reductor operand is a constant")
+      return nullptr;
+    }
 
-// the header phi must be used directly (TODO allow Trunc/SExt/ZExt) by the reductor
-  int phiIdx = firstConst == redInst->getOperand(0) ? 1 : 0;
-  if (redInst->getOperand(phiIdx) != &headerPhi) {
-    REASON("increment does not use phi node direcly")
-    return nullptr;
-  }
+  // the header phi must be used directly (TODO allow Trunc/SExt/ZExt) by the reductor
+    int phiIdx = firstConst == redInst->getOperand(0) ? 1 : 0;
+    if (redInst->getOperand(phiIdx) != &headerPhi) {
+      REASON("increment does not use phi node direcly")
+      return nullptr;
+    }
 
-// is the increment constant a valid stride?
-  Constant * incConst = firstConst ? firstConst : secConst;
-  int64_t inc;
-  if (auto * intIncrement = dyn_cast<ConstantInt>(incConst)) {
-    inc =  sign * intIncrement->getSExtValue();
-  } else if (auto * fpInc = dyn_cast<ConstantFP>(incConst)) {
-    RV_UNUSED(fpInc);
-    REASON("TODO implement floating point strides (fast math)")
-    return nullptr; // TODO allow natural number fp increments in fast-math
+    // "C - phi" negates the phi in every iteration
+    if (sign < 0 && phiIdx != 0) {
+      REASON("phi node is subtracted")
+      return nullptr;
+    }
+
+  // is the increment constant a valid stride?
+    Constant * incConst = firstConst ? firstConst : secConst;
+    if (auto * intIncrement = dyn_cast<ConstantInt>(incConst)) {
+      inc =  sign * intIncrement->getSExtValue();
+    } else {
+      REASON("TODO implement floating point strides (fast math)")
+      return nullptr; // TODO allow natural number fp increments in fast-math
+    }
   }
 
 // match.
@@ -291,7 +400,9 @@ ClassifyReduction(Reduction & red) {
     if (nodeKind != RedKind::Bot) {
       // verify that there is exactly one incoming operand from the chain
       bool foundChainOperand = false;
-      for (size_t i = 0; i < inst->getNumOperands(); ++i) {
+      // the condition of a min/max select is not an input
+      size_t firstOperand = isa<SelectInst>(inst) ? 1 : 0;
+      for (size_t i = firstOperand; i < inst->getNumOperands(); ++i) {
         auto * opInst = dyn_cast<Instruction>(inst->getOperand(i));
         if (opInst && red.elements.count(opInst)) {
           if (foundChainOperand) {
@@ -431,6 +542,69 @@ ReductionAnalysis::analyze(Loop & hostLoop) {
 
     IF_DEBUG_RED { red->dump(); }
   }
+
+  // pair index-tracking recurrences with their min/max reductions
+  for (auto * seedPhi : seedNodes) {
+    auto * red = getReductionInfo(*seedPhi);
+    if (!red || red->keyRed) continue;
+    if (red->kind != RedKind::Bot && red->kind != RedKind::ArgMin && red->kind != RedKind::ArgMax) continue;
+
+    bool hinted = red->kind != RedKind::Bot;
+    if (!tryMatchArgReduction(*red) && hinted) {
+      IF_DEBUG_RED { errs() << "red: could not pair arg reduction hint with a min/max reduction: " << *seedPhi << "\n"; }
+      red->kind = RedKind::Top;
+    }
+  }
+}
+
+bool
+ReductionAnalysis::tryMatchArgReduction(Reduction & red) {
+  if (red.elements.size() != 2) return false;
+
+  PHINode * phi = nullptr;
+  SelectInst * sel = nullptr;
+  for (auto * elem : red.elements) {
+    if (isa<PHINode>(elem)) phi = cast<PHINode>(elem);
+    else sel = dyn_cast<SelectInst>(elem);
+  }
+  if (!phi || !sel) return false;
+
+  // the select condition decides a min/max reduction
+  auto * cond = dyn_cast<CmpInst>(sel->getCondition());
+  auto * keyRed = cond ? getReductionInfo(*cond) : nullptr;
+  if (!keyRed || !IsMinMaxKind(keyRed->kind)) return false;
+
+  SelectInst * keySel = nullptr;
+  for (auto * elem : keyRed->elements) {
+    auto * keyElem = dyn_cast<SelectInst>(elem);
+    if (keyElem && keyElem->getCondition() == cond) keySel = keyElem;
+  }
+  if (!keySel) return false;
+
+  // both select the new value on the same outcome
+  auto * keyTrueInst = dyn_cast<Instruction>(keySel->getTrueValue());
+  bool keyNewOnTrue = !keyTrueInst || !keyRed->contains(*keyTrueInst);
+  bool idxNewOnTrue = sel->getFalseValue() == phi;
+  if (!idxNewOnTrue && sel->getTrueValue() != phi) return false;
+  if (keyNewOnTrue != idxNewOnTrue) return false;
+
+  // the selected index has to increase from one iteration to the next
+  Value * idxVal = idxNewOnTrue ? sel->getTrueValue() : sel->getFalseValue();
+  while (isa<SExtInst>(idxVal) || isa<ZExtInst>(idxVal)) {
+    idxVal = cast<CastInst>(idxVal)->getOperand(0);
+  }
+  auto * idxInst = dyn_cast<Instruction>(idxVal);
+  auto * idxPattern = idxInst ? getStrideInfo(*idxInst) : nullptr;
+  if (!idxPattern || idxPattern->inc <= 0 || idxPattern->isPointer()) return false;
+  if (!phi->getType()->isIntegerTy()) return false;
+
+  bool isMax = keyRed->kind == RedKind::SMax || keyRed->kind == RedKind::UMax || keyRed->kind == RedKind::FMax;
+  red.kind = isMax ? RedKind::ArgMax : RedKind::ArgMin;
+  red.keyRed = keyRed;
+  keyRed->argReds.push_back(&red);
+
+  IF_DEBUG_RED { errs() << "red: index of " << to_string(keyRed->kind) << " reduction: "; red.dump(); }
+  return true;
 }
 
 StridePattern *
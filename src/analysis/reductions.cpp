@@ -9,6 +9,7 @@
 #include "rv/analysis/reductions.h"
 
 #include "llvm/IR/Instructions.h"
+#include "llvm/IR/Intrinsics.h"
 #include "llvm/IR/Type.h"
 #include "llvm/IR/Constants.h"
 #include "llvm/Support/raw_ostream.h"
@@ -37,6 +38,21 @@ RedKind JoinKinds(RedKind A, RedKind B) {
   return A; // A == B
 }
 
+bool
+IsMinMaxKind(RedKind red) {
+  switch (red) {
+    case RedKind::SMax:
+    case RedKind::UMax:
+    case RedKind::SMin:
+    case RedKind::UMin:
+    case RedKind::FMax:
+    case RedKind::FMin:
+      return true;
+    default:
+      return false;
+  }
+}
+
 
 StringRef
 to_string(RedKind red) {
@@ -53,6 +69,11 @@ to_string(RedKind red) {
     case RedKind::UMax: return "UMax";
     case RedKind::SMin: return "SMin";
     case RedKind::UMin: return "UMin";
+    case RedKind::FMax: return "FMax";
+    case RedKind::FMin: return "FMin";
+    case RedKind::Xor: return "Xor";
+    case RedKind::ArgMax: return "ArgMax";
+    case RedKind::ArgMin: return "ArgMin";
   }
 }
 
@@ -72,12 +93,6 @@ from_string(StringRef redKindText, RedKind & oRedKind) {
 
 Constant&
 GetNeutralElement_fp(RedKind redKind, Type & chainTy) {
-  bool isDouble = chainTy.isDoubleTy();
-  const double maxDouble = std::numeric_limits<double>::max();
-  const double minDouble = std::numeric_limits<double>::min();
-  const double maxFloat = std::numeric_limits<float>::max();
-  const double minFloat = std::numeric_limits<float>::min();
-
   switch(redKind) {
     default:
       llvm_unreachable("reduction unsupported for this type");
@@ -89,11 +104,13 @@ GetNeutralElement_fp(RedKind redKind, Type & chainTy) {
 
     case RedKind::SMax:
     case RedKind::UMax:
-      return *ConstantFP::get(&chainTy, isDouble ? minDouble : minFloat);
+    case RedKind::FMax:
+      return *ConstantFP::getInfinity(&chainTy, true);
 
     case RedKind::SMin:
     case RedKind::UMin:
-      return *ConstantFP::get(&chainTy, isDouble ? maxDouble : maxFloat);
+    case RedKind::FMin:
+      return *ConstantFP::getInfinity(&chainTy, false);
 
   }
 }
@@ -113,6 +130,7 @@ GetNeutralElement_int(RedKind redKind, Type & chainTy) {
   case RedKind::And:
     return *ConstantInt::getAllOnesValue(&chainTy);
   case RedKind::Or:
+  case RedKind::Xor:
     return *ConstantInt::getNullValue(&chainTy);
   case RedKind::UMax:
     return *ConstantInt::get(&chainTy, 0); // 00..00
@@ -154,6 +172,12 @@ InferInstRedKind(Instruction & inst) {
     case Instruction::And:
       return RedKind::And;
 
+    case Instruction::Xor:
+      return RedKind::Xor;
+
+    case Instruction::Call:
+      return InferCallRedKind(cast<CallInst>(inst));
+
   // preserving operations
     case Instruction::Select:
     case Instruction::PHI:
@@ -166,5 +190,20 @@ InferInstRedKind(Instruction & inst) {
   abort();
 }
 
+RedKind
+InferCallRedKind(CallInst & call) {
+  auto * callee = call.getCalledFunction();
+  if (!callee) return RedKind::Top;
+
+  switch (callee->getIntrinsicID()) {
+    case Intrinsic::maxnum:
+      return RedKind::FMax;
+    case Intrinsic::minnum:
+      return RedKind::FMin;
+    default:
+      return RedKind::Top;
+  }
+}
+
 
 } // namespace rv
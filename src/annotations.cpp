@@ -22,6 +22,7 @@ using namespace llvm;
 namespace {
   const char* rv_atomic_string = "rv_atomic";
   const char* rv_redkind_string  = "rv_redkind";
+  const char* rv_align_string  = "rv_align";
 }
 
 namespace rv {
@@ -65,4 +66,27 @@ ReadReductionHint(const llvm::PHINode & loopHeaderPhi) {
   return kind;
 }
 
+void
+SetAlignmentHint(llvm::Instruction & ptrInst, unsigned alignment) {
+  if (alignment <= 1) {
+    ptrInst.setMetadata(rv_align_string, nullptr);
+    return;
+  }
+
+  auto & ctx = ptrInst.getContext();
+  auto * alignConst = ConstantInt::get(Type::getInt32Ty(ctx), alignment);
+  auto * boxedNode = MDNode::get(ctx, ConstantAsMetadata::get(alignConst));
+  ptrInst.setMetadata(rv_align_string, boxedNode);
+}
+
+unsigned
+ReadAlignmentHint(const llvm::Instruction & ptrInst) {
+  auto * boxedHint = ptrInst.getMetadata(rv_align_string);
+  if (!boxedHint) return 1; // unknown
+  assert(boxedHint->getNumOperands() >= 1);
+
+  auto * alignConst = mdconst::extract<ConstantInt>(boxedHint->getOperand(0));
+  return alignConst->getZExtValue();
+}
+
 }
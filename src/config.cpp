@@ -42,9 +42,12 @@ Config::Config()
 
 // backend defaults
 , scalarizeIndexComputation(true)
-, useScatterGatherIntrinsics(true)
+, useScatterGatherIntrinsics(!CheckFlag("RV_DISABLE_GATHER"))
+, useSafeAddressGather(!CheckFlag("RV_DISABLE_SAFEGATHER"))
+, useActiveLaneLoops(!CheckFlag("RV_DISABLE_LANELOOPS"))
 , enableMaskedMove(true)
-, enableInterleaved(false)
+, enableBlendStores(CheckFlag("RV_BLEND_STORES"))
+, enableInterleaved(CheckFlag("RV_INTERLEAVED"))
 , useSafeDivisors(true)
 
 // optimization defaults
@@ -55,10 +58,21 @@ Config::Config()
 , enableHeuristicBOSCC(CheckFlag("RV_EXP_BOSCC"))
 , enableCoherentIF(CheckFlag("RV_EXP_CIF"))
 , enableOptimizedBlends(!CheckFlag("RV_NO_BLENDOPT"))
+, enableSinCosFusion(!CheckFlag("RV_NO_SINCOS"))
+, enablePowSpecialization(!CheckFlag("RV_NO_POWSPEC"))
+
+// loop vectorizer defaults
+, enableMultiVersioning(CheckFlag("RV_MULTI_VERSION"))
+, enableTailFolding(CheckFlag("RV_TAIL_FOLD"))
+, enableHalfWidthEpilogue(CheckFlag("RV_HALF_EPILOGUE"))
+, enableAutoVectorization(CheckFlag("RV_AUTO_VECTORIZE"))
+, enableEarlyExits(CheckFlag("RV_EARLY_EXIT"))
+, enableAlignmentPeeling(CheckFlag("RV_PEEL_ALIGN"))
 
 // enable greedy inter-procedural vectorization
 , enableGreedyIPV(CheckFlag("RV_IPV"))
 , maxULPErrorBound(10)
+, preferVectorLibrary(CheckFlag("RV_PREFER_VECLIB"))
 
 // feature flags
 , useVE(false)
@@ -66,6 +80,8 @@ Config::Config()
 , useAVX(false)
 , useAVX2(false)
 , useAVX512(false)
+, useAVX512CD(false)
+, useAVX512VL(false)
 , useNEON(false)
 , useADVSIMD(false)
 {}
@@ -85,6 +101,8 @@ Config::createDefaultConfig() {
   } else if (arch == "avx512") {
     Report() << "RV_ARCH: configured for avx512!\n";
     config.useAVX512 = true;
+    config.useAVX512CD = true;
+    config.useAVX512VL = true;
     config.useAVX2 = true;
     config.useSSE = true;
   } else if (arch == "advsimd") {
@@ -134,6 +152,8 @@ Config::createForFunction(Function & F) {
       {"+avx", [&config]() { config.useAVX = true; } },
       {"+avx2", [&config]() { config.useAVX2 = true; } },
       {"+avx512f", [&config]() { config.useAVX512 = true; } },
+      {"+avx512cd", [&config]() { config.useAVX512CD = true; } },
+      {"+avx512vl", [&config]() { config.useAVX512VL = true; } },
       {"+neon", [&config]() { config.useADVSIMD = true; config.useNEON = true; } }
   };
 
@@ -184,6 +204,9 @@ printVAFlags(const Config & config, llvm::raw_ostream & out) {
 static void
 printNativeFlags(const Config & config, llvm::raw_ostream & out) {
    out << "nat:  useScatterGather = " << config.useScatterGatherIntrinsics
+       << ", useSafeAddressGather = " << config.useSafeAddressGather
+       << ", useActiveLaneLoops = " << config.useActiveLaneLoops
+       << ", enableBlendStores = " << config.enableBlendStores
        << ", enableInterleaved = " << config.enableInterleaved
        << ", useSafeDiv = " << config.useSafeDivisors;
 }
@@ -196,14 +219,23 @@ printOptFlags(const Config & config, llvm::raw_ostream & out) {
         << ", enableHeuristicBOSCC = " << config.enableHeuristicBOSCC
         << ", enableCoherentIF = " << config.enableCoherentIF
         << ", enableOptimizedBlends = " << config.enableOptimizedBlends
+        << ", enableSinCosFusion = " << config.enableSinCosFusion
+        << ", enablePowSpecialization = " << config.enablePowSpecialization
         << ", enableIRPolish = " << config.enableIRPolish
+        << ", multiVersioning = " << config.enableMultiVersioning
+        << ", tailFolding = " << config.enableTailFolding
+        << ", halfWidthEpilogue = " << config.enableHalfWidthEpilogue
+        << ", autoVectorization = " << config.enableAutoVectorization
+        << ", earlyExits = " << config.enableEarlyExits
+        << ", alignmentPeeling = " << config.enableAlignmentPeeling
         << ", greedyIPV = " << config.enableGreedyIPV
-        << ", maxULPErrorBound = " << ulp_to_string(config.maxULPErrorBound);
+        << ", maxULPErrorBound = " << ulp_to_string(config.maxULPErrorBound)
+        << ", preferVectorLibrary = " << config.preferVectorLibrary;
 }
 
 static void
 printFeatureFlags(const Config & config, llvm::raw_ostream & out) {
-  out << "arch: useSSE = " << config.useSSE << ", useAVX = " << config.useAVX << ", useAVX2 = " << config.useAVX2 << ", useAVX512 = " << config.useAVX512 << ", useNEON = " << config.useNEON << ", useADVSIMD = " << config.useADVSIMD << ", useVE = " << config.useVE << "\n";
+  out << "arch: useSSE = " << config.useSSE << ", useAVX = " << config.useAVX << ", useAVX2 = " << config.useAVX2 << ", useAVX512 = " << config.useAVX512 << ", useAVX512CD = " << config.useAVX512CD << ", useAVX512VL = " << config.useAVX512VL << ", useNEON = " << config.useNEON << ", useADVSIMD = " << config.useADVSIMD << ", useVE = " << config.useVE << "\n";
 }
 
 
@@ -235,7 +235,8 @@ GetIntrinsicMapping(Function & func, RVIntrinsic rvIntrin) {
         ));
     } break;
 
-    case RVIntrinsic::Compact: {
+    case RVIntrinsic::Compact:
+    case RVIntrinsic::Expand: {
       return (VectorMapping(
         &func,
         &func,
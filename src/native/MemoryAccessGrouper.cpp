@@ -16,7 +16,7 @@
 
 #define IF_DEBUG_MG if (false)
 
-const int64_t groupLimit = 64;
+const int64_t groupLimit = 64; // in elements
 
 using namespace llvm;
 using namespace rv;
@@ -99,6 +99,10 @@ const SCEV *MemoryAccessGrouper::add(Value *addrVal) {
 
     IF_DEBUG_MG errs() << "\tresult: " << offset << "\n";
 
+    // group members are indexed by lane elements (not bytes)
+    if (offset % laneByteSize != 0) continue;
+    offset /= laneByteSize;
+
     if (std::abs(offset) >= groupLimit) continue;
 
     IF_DEBUG_MG errs() << "== " << offset << "\n";
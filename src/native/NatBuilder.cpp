@@ -10,12 +10,16 @@
 
 #include <llvm/ADT/PostOrderIterator.h>
 #include <llvm/ADT/SmallSet.h>
+#include <llvm/Analysis/CFG.h>
+#include <llvm/Analysis/Loads.h>
+#include <llvm/Analysis/ScalarEvolutionExpressions.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Metadata.h>
 #include "llvm/IR/IntrinsicsX86.h"
 #include <report.h>
 #include <fstream>
+#include <cmath>
 
 #include "NatBuilder.h"
 #include "Utils.h"
@@ -62,7 +66,7 @@ unsigned numMaskedGather, numMaskedScatter, numGather, numScatter,
     numUniLoads, numUniStores, numUniAllocas, numSlowAllocas;
 
 unsigned numVecGEPs, numScalGEPs, numInterGEPs, numVecBCs, numScalBCs;
-unsigned numVecCalls, numSemiCalls, numFallCalls, numCascadeCalls, numRVIntrinsics;
+unsigned numVecCalls, numSemiCalls, numFallCalls, numCascadeCalls, numLaneLoopCalls, numFusedCalls, numSpecializedCalls, numRVIntrinsics;
 unsigned numScalarized, numVectorized, numFallbacked, numLazy;
 
 unsigned numConstLoadMasks, numUniLoadMasks, numVarLoadMasks;
@@ -110,7 +114,9 @@ void NatBuilder::printStatistics() {
   // call statistics
   Report() << "nat calls:\n"
            << "\tVectorized: " << numVecCalls << "/" << numSemiCalls << " fully/semi\n"
-           << "\tReplicated: " << numFallCalls << "/" << numCascadeCalls << " replicated/cascaded\n"
+           << "\tFused: " << numFusedCalls << " sin/cos pairs\n"
+           << "\tSpecialized: " << numSpecializedCalls << " pow calls with constant exponent\n"
+           << "\tReplicated: " << numFallCalls << "/" << numCascadeCalls << "/" << numLaneLoopCalls << " replicated/cascaded/lane-looped\n"
            << "\tRV Intrinsics: " << numRVIntrinsics << " intrinsics\n";
 
 #if 0
@@ -161,8 +167,11 @@ void NatBuilder::printStatistics() {
   // call statistics
   file << "vec-call," << numVecCalls << "\n";
   file << "semi-vec-call," << numSemiCalls << "\n";
+  file << "fused-sincos-call," << numFusedCalls << "\n";
+  file << "specialized-pow-call," << numSpecializedCalls << "\n";
   file << "replicated-call," << numFallCalls << "\n";
   file << "cascaded-call," << numCascadeCalls << "\n";
+  file << "lane-loop-call," << numLaneLoopCalls << "\n";
   file << "rv-intrinsic," << numRVIntrinsics << "\n";
 
   // general statistics
@@ -186,10 +195,12 @@ NatBuilder::NatBuilder(Config _config, PlatformInfo &_platInfo, VectorizationInf
     platInfo(_platInfo),
     vecInfo(_vecInfo),
     dominatorTree(FAM.getResult<DominatorTreeAnalysis>(vecInfo.getScalarFunction())),
+    postDominatorTree(FAM.getResult<PostDominatorTreeAnalysis>(vecInfo.getScalarFunction())),
     memDepRes(FAM.getResult<MemoryDependenceAnalysis>(vecInfo.getScalarFunction())),
     SE(FAM.getResult<ScalarEvolutionAnalysis>(vecInfo.getScalarFunction())),
     reda(_reda),
     undeadMasks(vecInfo, FAM),
+    allTrueMasks(vecInfo, undeadMasks, FAM),
     layout(_vecInfo.getScalarFunction().getParent()),
     i1Ty(IntegerType::get(_vecInfo.getMapping().vectorFn->getContext(), 1)),
     i32Ty(IntegerType::get(_vecInfo.getMapping().vectorFn->getContext(), 32)),
@@ -197,6 +208,7 @@ NatBuilder::NatBuilder(Config _config, PlatformInfo &_platInfo, VectorizationInf
     keepScalar(),
     cascadeLoadMap(),
     cascadeStoreMap(),
+    scratchSlots(),
     vectorValueMap(),
     scalarValueMap(),
     basicBlockMap(),
@@ -371,6 +383,8 @@ void NatBuilder::vectorize(BasicBlock *const bb, BasicBlock *vecBlock) {
     GetElementPtrInst *gep = dyn_cast<GetElementPtrInst>(inst);
     BitCastInst *bc = dyn_cast<BitCastInst>(inst);
     AllocaInst *alloca = dyn_cast<AllocaInst>(inst);
+    AtomicRMWInst *rmw = dyn_cast<AtomicRMWInst>(inst);
+    SelectInst *select = dyn_cast<SelectInst>(inst);
 
     // analyze memory predicate
     if (load || store) {
@@ -411,6 +425,7 @@ void NatBuilder::vectorize(BasicBlock *const bb, BasicBlock *vecBlock) {
         case RVIntrinsic::Extract: vectorizeExtractCall(call); break;
         case RVIntrinsic::Insert: vectorizeInsertCall(call); break;
         case RVIntrinsic::Compact: vectorizeCompactCall(call); break;
+        case RVIntrinsic::Expand: vectorizeExpandCall(call); break;
         case RVIntrinsic::Mask: mapVectorValue(call, requestVectorPredicate(*call->getParent())); break;
         case RVIntrinsic::VecLoad: vectorizeLoadCall(call); break;
         case RVIntrinsic::VecStore: vectorizeStoreCall(call); break;
@@ -432,8 +447,14 @@ void NatBuilder::vectorize(BasicBlock *const bb, BasicBlock *vecBlock) {
       vectorizePHIInstruction(phi);
     } else if (alloca && shouldVectorize(inst)) {
       vectorizeAlloca(alloca);
+    } else if (rmw && shouldVectorize(inst)) {
+      vectorizeAtomicRMW(*rmw);
     } else if (gep || bc) {
       continue; // skipped
+    } else if (select && select->getCondition()->getType()->isIntegerTy(1) && shouldVectorize(inst) &&
+               allTrueMasks.isAllTrue(*select->getCondition(), *bb)) {
+      // blend on an all-true mask
+      mapVectorValue(select, requestVectorValue(select->getTrueValue()));
     } else if (canVectorize(inst) && shouldVectorize(inst)) {
       vectorizeInstruction(inst);
     } else if (!canVectorize(inst) && shouldVectorize(inst)){
@@ -477,7 +498,7 @@ Value&
 NatBuilder::createAnyGuard(bool instNeedsGuard, BasicBlock & origBlock, Instruction & inst, bool producesValue, std::function<Value*(IRBuilder<>&)> genFunc) {
   auto * scalarMask = vecInfo.getPredicate(origBlock);
   // only emit a guard if rv_any(p) may be false AND the emitted instructions will need it.
-  bool needsGuard = instNeedsGuard && !undeadMasks.isUndead(*scalarMask, origBlock);
+  bool needsGuard = instNeedsGuard && !undeadMasks.isUndead(*scalarMask, origBlock) && !hasAllTruePredicate(origBlock);
 
   BasicBlock* memBlock, * continueBlock;
 
@@ -742,6 +763,132 @@ bool IsVectorizableTy(const Type & ty) {
   return ty.isPointerTy() || ty.isIntegerTy() || ty.isFloatingPointTy();
 }
 
+bool
+NatBuilder::canScalarizeActiveLanes(Instruction & inst, bool packResult) {
+  if (!config.useActiveLaneLoops) return false;
+  if (vectorWidth() > 32) return false; // the lanes are enumerated in an i32 ballot
+  if (isa<PHINode>(inst) || isa<AllocaInst>(inst) || inst.isTerminator()) return false;
+  if (!inst.getType()->isVoidTy() && !packResult) return false;
+
+  // varying operands are extracted from their vector value
+  for (const auto & op : inst.operands()) {
+    if (!isa<Instruction>(op.get()) && !isa<Argument>(op.get())) continue;
+    if (getVectorShape(*op.get()).isUniform()) continue;
+    if (!IsVectorizableTy(*op->getType())) return false;
+  }
+  return true;
+}
+
+void
+NatBuilder::scalarizeActiveLanes(BasicBlock & srcBlock, Instruction & inst, bool packResult) {
+  Value *predicate = vecInfo.getPredicate(srcBlock);
+  assert(predicate && "expected predicate!");
+
+  auto & context = vecInfo.getVectorFunction().getContext();
+  Module *mod = vecInfo.getMapping().vectorFn->getParent();
+
+  // request all operands before entering the loop
+  SmallVector<Value*, 4> mappedOps;
+  SmallVector<bool, 4> perLaneOps;
+  for (auto & op : inst.operands()) {
+    bool varying = (isa<Instruction>(op.get()) || isa<Argument>(op.get())) && !getVectorShape(*op.get()).isUniform();
+    mappedOps.push_back(varying ? requestVectorValue(op.get()) : requestScalarValue(op.get()));
+    perLaneOps.push_back(varying);
+  }
+
+  // one bit per active lane
+  auto * activeLanes = createVectorMaskSummary(*i32Ty, requestVectorValue(predicate), builder, RVIntrinsic::Ballot);
+
+  auto * entryBlock = builder.GetInsertBlock();
+  auto * headerBlock = BasicBlock::Create(context, "lane_loop", &vecInfo.getVectorFunction());
+  auto * bodyBlock = BasicBlock::Create(context, "lane_body", &vecInfo.getVectorFunction());
+  auto * exitBlock = BasicBlock::Create(context, "lane_exit", &vecInfo.getVectorFunction());
+  builder.CreateBr(headerBlock);
+
+  // header: any lanes left?
+  builder.SetInsertPoint(headerBlock);
+  auto * vecTy = packResult ? VectorType::get(inst.getType(), vectorWidth()) : nullptr;
+  auto * lanePhi = builder.CreatePHI(i32Ty, 2, "active_lanes");
+  auto * accuPhi = packResult ? builder.CreatePHI(vecTy, 2, "lane_accu") : nullptr;
+  auto * anyLeft = builder.CreateICmpNE(lanePhi, ConstantInt::getNullValue(i32Ty), "any_lane");
+  builder.CreateCondBr(anyLeft, bodyBlock, exitBlock);
+
+  // body: replicate @inst for the lowest active lane
+  builder.SetInsertPoint(bodyBlock);
+  auto * cttzDecl = Intrinsic::getDeclaration(mod, Intrinsic::cttz, i32Ty);
+  auto * laneIdx = builder.CreateCall(cttzDecl, {lanePhi, builder.getTrue()}, "lane_idx");
+
+  auto * cpInst = inst.clone();
+  for (unsigned i = 0; i < inst.getNumOperands(); ++i) {
+    Value * laneOp = perLaneOps[i] ? builder.CreateExtractElement(mappedOps[i], laneIdx, "lane_op") : mappedOps[i];
+    cpInst->setOperand(i, laneOp);
+  }
+  builder.Insert(cpInst, inst.getName());
+  auto * nextAccu = packResult ? builder.CreateInsertElement(accuPhi, cpInst, laneIdx, "lane_insert") : nullptr;
+
+  // clear the lowest set bit
+  auto * laneMinusOne = builder.CreateSub(lanePhi, ConstantInt::get(i32Ty, 1));
+  auto * nextLanes = builder.CreateAnd(lanePhi, laneMinusOne, "next_lanes");
+  builder.CreateBr(headerBlock);
+
+  lanePhi->addIncoming(activeLanes, entryBlock);
+  lanePhi->addIncoming(nextLanes, bodyBlock);
+  if (accuPhi) {
+    accuPhi->addIncoming(UndefValue::get(vecTy), entryBlock);
+    accuPhi->addIncoming(nextAccu, bodyBlock);
+    mapVectorValue(&inst, accuPhi);
+  }
+
+  // remap to exit block
+  builder.SetInsertPoint(exitBlock);
+  mapVectorValue(inst.getParent(), exitBlock);
+}
+
+NatBuilder::ScalarizeMode
+NatBuilder::pickScalarizeMode(Instruction & inst, bool packResult, bool needsGuard) {
+  auto defaultMode = needsGuard ? ScalarizeMode::Cascade : ScalarizeMode::Unguarded;
+  auto * tti = platInfo.getTTI();
+  if (!tti || !canScalarizeActiveLanes(inst, packResult)) return defaultMode;
+
+  const auto costKind = TargetTransformInfo::TCK_RecipThroughput;
+  const double numLanes = vectorWidth();
+  const double numActive = vecInfo.getLaneDensity(*inst.getParent()) * numLanes;
+
+  int replCost = std::max(1, tti->getInstructionCost(&inst, costKind));
+  int branchCost = tti->getCFInstrCost(Instruction::Br, costKind);
+  int aluCost = tti->getArithmeticInstrCost(Instruction::And, i32Ty, costKind);
+  int maskBitCost = tti->getVectorInstrCost(Instruction::ExtractElement, VectorType::get(i1Ty, vectorWidth()), 0);
+
+  // moving lane values in and out of vectors (constant lane index when unrolled, dynamic in the loop)
+  int fixedLaneCost = 0, dynLaneCost = 0;
+  for (const auto & op : inst.operands()) {
+    if (!isa<Instruction>(op.get()) && !isa<Argument>(op.get())) continue;
+    if (getVectorShape(*op.get()).isUniform()) continue;
+    auto * opVecTy = VectorType::get(op->getType(), vectorWidth());
+    fixedLaneCost += tti->getVectorInstrCost(Instruction::ExtractElement, opVecTy, 0);
+    dynLaneCost += tti->getVectorInstrCost(Instruction::ExtractElement, opVecTy, -1);
+  }
+  if (packResult && !inst.getType()->isVoidTy()) {
+    auto * resVecTy = VectorType::get(inst.getType(), vectorWidth());
+    fixedLaneCost += tti->getVectorInstrCost(Instruction::InsertElement, resVecTy, 0);
+    dynLaneCost += tti->getVectorInstrCost(Instruction::InsertElement, resVecTy, -1);
+  }
+
+  // all lanes execute the replica
+  double unguardedCost = numLanes * (replCost + fixedLaneCost);
+  // all lanes test their mask bit, only active lanes execute the replica
+  double cascadeCost = numLanes * (maskBitCost + branchCost) + numActive * (replCost + fixedLaneCost);
+  // ballot once, then cttz, clear lowest bit and branch back per active lane
+  double loopCost = 2 * aluCost + branchCost + numActive * (3 * aluCost + branchCost + replCost + dynLaneCost);
+
+  IF_DEBUG_NAT { errs() << "nat: scalarize " << inst << " with " << numActive << " active lanes, cost (unguarded/cascade/loop): "
+                        << unguardedCost << "/" << cascadeCost << "/" << loopCost << "\n"; }
+
+  if (loopCost < cascadeCost && (needsGuard || loopCost < unguardedCost)) return ScalarizeMode::ActiveLanes;
+  if (needsGuard || cascadeCost < unguardedCost) return ScalarizeMode::Cascade;
+  return ScalarizeMode::Unguarded;
+}
+
 void NatBuilder::vectorizeAlloca(AllocaInst *const allocaInst) {
   auto allocAlign = allocaInst->getAlignment();
   auto * allocTy = allocaInst->getType()->getElementType();
@@ -786,7 +933,7 @@ void NatBuilder::replicateInstruction(Instruction *const inst) {
   // repeat from line 3 for all lanes
   Type *type = inst->getType();
   auto * mask = vecInfo.getPredicate(*inst->getParent());
-  bool nonTrivialMask = mask && !isa<Constant>(mask);
+  bool nonTrivialMask = mask && !isa<Constant>(mask) && !hasAllTruePredicate(*inst->getParent());
 
   // scalarized operation with side effects in predicated context -> if cascade & scalarize
   //
@@ -798,15 +945,127 @@ void NatBuilder::replicateInstruction(Instruction *const inst) {
         };
 
   bool packResult = IsVectorizableTy(*type);
-  if (nonTrivialMask && NeedsGuarding(*inst)) {
-    ValVec resVec = scalarizeCascaded(*inst->getParent(), *inst, packResult, replFunc);
-  } else {
-    scalarize(*inst->getParent(), *inst, packResult, replFunc);
+  bool needsGuard = nonTrivialMask && NeedsGuarding(*inst);
+  auto mode = nonTrivialMask ? pickScalarizeMode(*inst, packResult, needsGuard) : ScalarizeMode::Unguarded;
+  switch (mode) {
+    case ScalarizeMode::Cascade: scalarizeCascaded(*inst->getParent(), *inst, packResult, replFunc); break;
+    case ScalarizeMode::ActiveLanes: scalarizeActiveLanes(*inst->getParent(), *inst, packResult); break;
+    case ScalarizeMode::Unguarded: scalarize(*inst->getParent(), *inst, packResult, replFunc); break;
   }
 
   ++numFallbacked;
 }
 
+// reduction kind that combines the operands of consecutive @op updates into one (Top if there is none)
+static RedKind
+GetAtomicRedKind(AtomicRMWInst::BinOp op) {
+  switch (op) {
+    case AtomicRMWInst::Add:
+    case AtomicRMWInst::Sub: return RedKind::Add; // x - a - b == x - (a + b)
+    case AtomicRMWInst::And: return RedKind::And;
+    case AtomicRMWInst::Or: return RedKind::Or;
+    case AtomicRMWInst::Xor: return RedKind::Xor;
+    case AtomicRMWInst::Max: return RedKind::SMax;
+    case AtomicRMWInst::Min: return RedKind::SMin;
+    case AtomicRMWInst::UMax: return RedKind::UMax;
+    case AtomicRMWInst::UMin: return RedKind::UMin;
+    // Xchg and Nand do not compose, FP updates would round differently when pre-combined
+    default: return RedKind::Top;
+  }
+}
+
+Value*
+NatBuilder::createAggregatedAtomic(AtomicRMWInst & rmw, RedKind redKind, Value * ptr, Value * vecVal, Value * mask, bool needsGuard) {
+  const int vecWidth = vectorWidth();
+  auto & neutral = GetNeutralElement(redKind, *rmw.getType());
+
+  // inactive lanes contribute the neutral element
+  auto * activeVal = builder.CreateSelect(mask, vecVal, getSplat(&neutral), "atomic_payload");
+  auto & inclusive = CreateVectorScan(builder, redKind, *activeVal);
+  auto * total = builder.CreateExtractElement(&inclusive, vecWidth - 1, "atomic_total");
+
+  // a single atomic update on behalf of all lanes
+  auto genFunc = [&](IRBuilder<> & builder) -> Value* {
+    auto * vecRmw = builder.CreateAtomicRMW(rmw.getOperation(), ptr, total, rmw.getOrdering(), rmw.getSyncScopeID());
+    vecRmw->setAlignment(rmw.getAlign());
+    return vecRmw;
+  };
+  Value * oldVal = needsGuard ? &createAnyGuard(true, *rmw.getParent(), rmw, true, genFunc) : genFunc(builder);
+
+  // each lane observes the old value updated by all lanes before it (as if the lanes executed in order)
+  SmallVector<int, 16> shiftIndices;
+  shiftIndices.push_back(vecWidth);
+  for (int i = 1; i < vecWidth; ++i) shiftIndices.push_back(i - 1);
+  auto * exclusive = builder.CreateShuffleVector(&inclusive, getSplat(&neutral), shiftIndices, "atomic_prefix");
+
+  auto * oldSplat = builder.CreateVectorSplat(vecWidth, oldVal);
+  if (rmw.getOperation() == AtomicRMWInst::Sub) {
+    return builder.CreateSub(oldSplat, exclusive, rmw.getName() + "_SIMD");
+  }
+  auto & laneVal = CreateReductInst(builder, redKind, *oldSplat, *exclusive);
+  laneVal.setName(rmw.getName() + "_SIMD");
+  return &laneVal;
+}
+
+void NatBuilder::vectorizeAtomicRMW(AtomicRMWInst & rmw) {
+  // volatile updates must not be merged (the number of volatile accesses has to stay the same)
+  RedKind redKind = rmw.isVolatile() ? RedKind::Top : GetAtomicRedKind(rmw.getOperation());
+  if (redKind == RedKind::Top) {
+    replicateInstruction(&rmw);
+    return;
+  }
+
+  auto & origBlock = *rmw.getParent();
+  auto * scaPtr = rmw.getPointerOperand();
+  auto * vecVal = requestVectorValue(rmw.getValOperand());
+  auto * mask = requestVectorPredicate(origBlock);
+
+  // all lanes update the same location -> one atomic for the whole vector
+  if (getVectorShape(*scaPtr).isUniform()) {
+    auto * scaMask = vecInfo.getPredicate(origBlock);
+    bool needsGuard = scaMask && !isa<Constant>(scaMask);
+    mapVectorValue(&rmw, createAggregatedAtomic(rmw, redKind, requestScalarValue(scaPtr), vecVal, mask, needsGuard));
+    ++numVectorized;
+    return;
+  }
+
+// varying pointers may still point to the same location at runtime. check that first
+  auto & ctx = builder.getContext();
+  auto & vecFunc = vecInfo.getVectorFunction();
+  auto * intPtrTy = layout.getIntPtrType(scaPtr->getType());
+  auto * addrVec = builder.CreatePtrToInt(requestVectorValue(scaPtr), getVectorType(intPtrTy, vectorWidth()), "atomic_addr");
+  auto * nullAddr = getSplat(ConstantInt::get(intPtrTy, 0));
+  auto & leaderAddr = CreateVectorReduce(config, builder, RedKind::UMax, *builder.CreateSelect(mask, addrVec, nullAddr), nullptr);
+  auto * otherAddr = builder.CreateAnd(mask, builder.CreateICmpNE(addrVec, builder.CreateVectorSplat(vectorWidth(), &leaderAddr)), "atomic_divergent");
+  auto * isUniform = builder.CreateAnd(createPTest(mask, false), builder.CreateNot(createPTest(otherAddr, false)), "atomic_uniform");
+
+  auto * uniBlock = BasicBlock::Create(ctx, "atomic_uni", &vecFunc);
+  auto * varBlock = BasicBlock::Create(ctx, "atomic_var", &vecFunc);
+  auto * contBlock = BasicBlock::Create(ctx, "atomic_cont", &vecFunc);
+  builder.CreateCondBr(isUniform, uniBlock, varBlock);
+
+  // at least one lane is active here
+  builder.SetInsertPoint(uniBlock);
+  auto * leaderPtr = builder.CreateIntToPtr(&leaderAddr, scaPtr->getType(), "atomic_ptr");
+  auto * uniRes = createAggregatedAtomic(rmw, redKind, leaderPtr, vecVal, mask, false);
+  auto * uniEnd = builder.GetInsertBlock();
+  builder.CreateBr(contBlock);
+
+  // one atomic per lane
+  builder.SetInsertPoint(varBlock);
+  replicateInstruction(&rmw);
+  auto * varRes = getVectorValue(rmw);
+  auto * varEnd = builder.GetInsertBlock();
+  builder.CreateBr(contBlock);
+
+  builder.SetInsertPoint(contBlock);
+  auto * phi = builder.CreatePHI(uniRes->getType(), 2, rmw.getName() + "_SIMD");
+  phi->addIncoming(uniRes, uniEnd);
+  phi->addIncoming(varRes, varEnd);
+  mapVectorValue(&rmw, phi);
+  mapVectorValue(&origBlock, contBlock);
+}
+
 /* expects that builder has valid insertion point set */
 void NatBuilder::vectorizeInstruction(Instruction *const inst) {
   assert(inst && "no instruction to vectorize");
@@ -1014,6 +1273,12 @@ NatBuilder::createVectorMaskSummary(Type & indexTy, Value * vecVal, IRBuilder<>
   Value * result = nullptr;
   switch (mode) {
     case RVIntrinsic::Ballot: {
+      // the mask already is a bit mask in a mask register (kmov)
+      if (config.hasMaskRegisters() && vecWidth <= indexTy.getScalarSizeInBits()) {
+        auto * maskBits = builder.CreateBitCast(vecVal, builder.getIntNTy(vecWidth), "rv_ballot");
+        return builder.CreateZExtOrTrunc(maskBits, &indexTy);
+      }
+
       // If SSE is available, but AVX and above are not, and the vector width is greater than 4, split the vector
       bool shouldSplitForISA = vecWidth > 4 && config.useSSE && !config.useAVX && !config.useAVX2 && !config.useAVX512;
       if (vecWidth > 8 || shouldSplitForISA) {
@@ -1078,7 +1343,7 @@ NatBuilder::createVectorMaskSummary(Type & indexTy, Value * vecVal, IRBuilder<>
     } break;
 
     case RVIntrinsic::PopCount: {
-      if (config.useAVX || config.useAVX2) {
+      if (config.useAVX || config.useAVX2 || config.hasMaskRegisters()) {
         // ISPC popcount pattern
         auto maskIntTy = builder.getIntNTy(vectorWidth());
         auto maskBitCast = builder.CreateBitCast(vecVal, maskIntTy);
@@ -1208,6 +1473,19 @@ NatBuilder::vectorizeAlignCall(CallInst *rvCall) {
     mapScalarValue(rvCall, requestScalarValue(vecArg));
 }
 
+// whether AVX-512 can compress/expand @vecTy in a register (vpcompress/vpexpand, 32 and 64 bit elements)
+// 128 and 256 bit vectors require AVX512VL
+static bool
+HasNativeCompress(const Config & config, Type & vecTy) {
+  if (!config.useAVX512) return false;
+  auto & fixedTy = cast<FixedVectorType>(vecTy);
+  unsigned elemBits = fixedTy.getScalarSizeInBits();
+  unsigned vecBits = elemBits * fixedTy.getNumElements();
+  bool isDataTy = fixedTy.getElementType()->isIntegerTy() || fixedTy.getElementType()->isFloatingPointTy();
+  if (!isDataTy || (elemBits != 32 && elemBits != 64)) return false;
+  return (vecBits == 512) || (config.useAVX512VL && (vecBits == 128 || vecBits == 256));
+}
+
 void
 NatBuilder::vectorizeCompactCall(CallInst *rvCall) {
   ++numRVIntrinsics;
@@ -1227,19 +1505,95 @@ NatBuilder::vectorizeCompactCall(CallInst *rvCall) {
   auto * vecVal  = requestVectorValue(vecArg);
   auto * maskVal = requestVectorValue(maskArg);
 
+// avx512 - vpcompress (lanes past the compacted elements keep their value)
+  if (HasNativeCompress(config, *vecVal->getType())) {
+    auto * compressDecl = Intrinsic::getDeclaration(vecInfo.getVectorFunction().getParent(), Intrinsic::x86_avx512_mask_compress, {vecVal->getType()});
+    mapVectorValue(rvCall, builder.CreateCall(compressDecl, {vecVal, vecVal, maskVal}, "rv_compact"));
+    return;
+  }
+
+// lookup table path: compact chunks of (at most) 8 lanes and append them
   auto vecWidth = cast<FixedVectorType>(maskVal->getType())->getNumElements();
-  auto tableIndex = createVectorMaskSummary(*rvCall->getType(), maskVal, builder, RVIntrinsic::Ballot);
-  auto table = createCompactLookupTable(vecWidth);
-  auto indices = builder.CreateLoad(builder.CreateInBoundsGEP(table, { builder.getInt32(0), tableIndex }), "rv_compact_indices");
-  Value * compacted = UndefValue::get(vecVal->getType());
-  for (size_t i = 0; i < vecWidth; ++i) {
-    auto index = builder.CreateExtractElement(indices, builder.getInt32(i), "rv_compact_index");
-    auto elem = builder.CreateExtractElement(vecVal, index, "rv_compact_elem");
-    compacted = builder.CreateInsertElement(compacted, elem, builder.getInt32(i), "rv_compact");
+  unsigned chunkWidth = std::min<unsigned>(vecWidth, 8);
+  auto table = createCompactLookupTable(chunkWidth);
+  auto * popCountDecl = Intrinsic::getDeclaration(vecInfo.getVectorFunction().getParent(), Intrinsic::ctpop, {i32Ty});
+
+  Value * compacted = vecVal;
+  Value * numCompacted = builder.getInt32(0);
+  for (unsigned chunkStart = 0; chunkStart < vecWidth; chunkStart += chunkWidth) {
+    Value * chunkMask = maskVal;
+    if (chunkWidth < vecWidth) {
+      SmallVector<int, 8> chunkLanes;
+      for (unsigned i = 0; i < chunkWidth; ++i) chunkLanes.push_back(chunkStart + i);
+      chunkMask = builder.CreateShuffleVector(maskVal, UndefValue::get(maskVal->getType()), chunkLanes, "rv_compact_chunk");
+    }
+    auto tableIndex = createVectorMaskSummary(*i32Ty, chunkMask, builder, RVIntrinsic::Ballot);
+    auto indices = builder.CreateLoad(builder.CreateInBoundsGEP(table, { builder.getInt32(0), tableIndex }), "rv_compact_indices");
+
+    // the selected elements of this chunk follow those of the previous chunks
+    for (size_t i = 0; i < chunkWidth; ++i) {
+      auto index = builder.CreateExtractElement(indices, builder.getInt32(i), "rv_compact_index");
+      index = builder.CreateAdd(index, builder.getInt32(chunkStart), "rv_compact_index");
+      auto elem = builder.CreateExtractElement(vecVal, index, "rv_compact_elem");
+
+      // positions past the vector end only receive unselected elements
+      Value * pos = builder.CreateAdd(numCompacted, builder.getInt32(i), "rv_compact_pos");
+      pos = builder.CreateSelect(builder.CreateICmpULT(pos, builder.getInt32(vecWidth)), pos, builder.getInt32(vecWidth - 1));
+      compacted = builder.CreateInsertElement(compacted, elem, pos, "rv_compact");
+    }
+    numCompacted = builder.CreateAdd(numCompacted, builder.CreateCall(popCountDecl, {tableIndex}), "rv_compact_num");
+  }
+
+  // lanes past the compacted elements keep their value (the table takes care of that for a single chunk)
+  if (chunkWidth < vecWidth) {
+    auto * laneIds = createContiguousVector(vecWidth, i32Ty, 0, 1);
+    auto * isCompacted = builder.CreateICmpULT(laneIds, builder.CreateVectorSplat(vecWidth, numCompacted));
+    compacted = builder.CreateSelect(isCompacted, compacted, vecVal, "rv_compact");
   }
   mapVectorValue(rvCall, compacted);
 }
 
+void
+NatBuilder::vectorizeExpandCall(CallInst *rvCall) {
+  ++numRVIntrinsics;
+
+  assert(rvCall->getNumArgOperands() == 2 && "expected 2 arguments for rv_expand(vec, mask)");
+
+  Value *vecArg  = rvCall->getArgOperand(0);
+  Value *maskArg = rvCall->getArgOperand(1);
+
+// uniform arg
+  if (getVectorShape(*vecArg).isUniform()) {
+    mapScalarValue(rvCall, vecArg);
+    return;
+  }
+
+// non-uniform arg
+  auto * vecVal  = requestVectorValue(vecArg);
+  auto * maskVal = requestVectorValue(maskArg);
+
+// avx512 - vpexpand (unselected lanes keep their value)
+  if (HasNativeCompress(config, *vecVal->getType())) {
+    auto * expandDecl = Intrinsic::getDeclaration(vecInfo.getVectorFunction().getParent(), Intrinsic::x86_avx512_mask_expand, {vecVal->getType()});
+    mapVectorValue(rvCall, builder.CreateCall(expandDecl, {vecVal, vecVal, maskVal}, "rv_expand"));
+    return;
+  }
+
+// generic: a selected lane receives the element with the index of its rank among the selected lanes
+  auto vecWidth = cast<FixedVectorType>(maskVal->getType())->getNumElements();
+  auto * laneBits = builder.CreateZExt(maskVal, getVectorType(i32Ty, vecWidth), "rv_expand_bits");
+  auto & inclusiveRanks = CreateVectorScan(builder, RedKind::Add, *laneBits);
+  auto * ranks = builder.CreateSub(&inclusiveRanks, laneBits, "rv_expand_rank");
+
+  Value * expanded = UndefValue::get(vecVal->getType());
+  for (size_t i = 0; i < vecWidth; ++i) {
+    auto index = builder.CreateExtractElement(ranks, builder.getInt32(i), "rv_expand_index");
+    auto elem = builder.CreateExtractElement(vecVal, index, "rv_expand_elem");
+    expanded = builder.CreateInsertElement(expanded, elem, builder.getInt32(i), "rv_expand");
+  }
+  mapVectorValue(rvCall, builder.CreateSelect(maskVal, expanded, vecVal, "rv_expand"));
+}
+
 Constant*
 NatBuilder::createCompactLookupTable(unsigned vecWidth) {
   assert(vecWidth <= 8);
@@ -1295,11 +1649,196 @@ CopyTargetAttributes(Function & destFunc, Function & srcFunc) {
   }
 }
 
+// sin/cos functions that share their range reduction in SLEEF's sincos
+struct SinCosDesc {
+  const char * sinName;
+  const char * cosName;
+  const char * sinCosName;
+};
+
+static const SinCosDesc SinCosFuncs[] = {
+  {"sinf", "cosf", "sincosf"},
+  {"sin", "cos", "sincos"},
+  {"llvm.sin.f32", "llvm.cos.f32", "sincosf"},
+  {"llvm.sin.f64", "llvm.cos.f64", "sincos"},
+};
+
+bool
+NatBuilder::vectorizeSinCosPair(CallInst & scalCall, bool hasCallPredicate) {
+  auto * callee = scalCall.getCalledFunction();
+  if (!callee || scalCall.getNumArgOperands() != 1) return false;
+
+  const SinCosDesc * desc = nullptr;
+  bool isSin = false;
+  for (const auto & cand : SinCosFuncs) {
+    if (callee->getName() == cand.sinName) { desc = &cand; isSin = true; break; }
+    if (callee->getName() == cand.cosName) { desc = &cand; break; }
+  }
+  if (!desc) return false;
+
+  // look for the partner call on the same operand later in this block (same predicate)
+  Value & scaArg = *scalCall.getArgOperand(0);
+  StringRef partnerName = isSin ? desc->cosName : desc->sinName;
+  CallInst * partnerCall = nullptr;
+  for (auto * user : scaArg.users()) {
+    auto * userCall = dyn_cast<CallInst>(user);
+    if (!userCall || userCall->getParent() != scalCall.getParent()) continue;
+    auto * userCallee = userCall->getCalledFunction();
+    if (!userCallee || userCallee->getName() != partnerName) continue;
+    if (!scalCall.comesBefore(userCall) || getVectorValue(*userCall) || !shouldVectorize(userCall)) continue;
+    partnerCall = userCall;
+    break;
+  }
+  if (!partnerCall) return false;
+
+  CallInst & sinCall = isSin ? scalCall : *partnerCall;
+  CallInst & cosCall = isSin ? *partnerCall : scalCall;
+
+  // the fused call has to satisfy both call sites
+  int ulpBound = std::min(GetCallSiteULPBound(sinCall, config.maxULPErrorBound),
+                          GetCallSiteULPBound(cosCall, config.maxULPErrorBound));
+
+  auto * scaTy = scaArg.getType();
+  auto * sinCosTy = FunctionType::get(StructType::get(scaTy, scaTy), {scaTy}, false);
+  VectorShapeVec argShapes = {vecInfo.getVectorShape(scaArg)};
+  auto funcResolver = platInfo.getResolver(desc->sinCosName, *sinCosTy, argShapes, vectorWidth(), hasCallPredicate, ulpBound);
+  if (!funcResolver) return false;
+
+  Function & simdFunc = funcResolver->requestVectorized();
+  CopyTargetAttributes(simdFunc, vecInfo.getScalarFunction());
+
+  auto * vecPair = builder.CreateCall(&simdFunc, {requestVectorValue(&scaArg)}, "sincos.rv");
+  mapVectorValue(&sinCall, builder.CreateExtractValue(vecPair, 0, sinCall.getName() + ".fused"));
+  mapVectorValue(&cosCall, builder.CreateExtractValue(vecPair, 1, cosCall.getName() + ".fused"));
+  ++numFusedCalls;
+  return true;
+}
+
+static bool
+IsPowFunc(StringRef funcName) {
+  return funcName == "powf" || funcName == "pow" || funcName == "llvm.pow.f32" || funcName == "llvm.pow.f64";
+}
+
+// estimated error (in tenths of ULP) of x^n by square-and-multiply.
+// Each fmul adds half an ULP. The relative error of an operand can be worth up to twice as many ULPs in the result (binade factor 2), squaring doubles it once more.
+static int
+GetPowChainError(unsigned n) {
+  int error = 0;
+  for (int bit = (int) Log2_32(n) - 1; bit >= 0; --bit) {
+    error = 4 * error + 5;
+    if (n & (1u << bit)) error = 2 * error + 5;
+  }
+  return error;
+}
+
+// value of @fpConst as a double
+static double
+GetDoubleValue(const ConstantFP & fpConst) {
+  bool losesInfo;
+  APFloat val = fpConst.getValueAPF();
+  val.convert(APFloat::IEEEdouble(), APFloat::rmNearestTiesToEven, &losesInfo);
+  return val.convertToDouble();
+}
+
+// largest integer exponent that is expanded into a multiplication chain
+static const unsigned MaxPowChainExponent = 32;
+
+bool
+NatBuilder::vectorizePowCall(CallInst & scalCall, bool hasCallPredicate) {
+  auto * callee = scalCall.getCalledFunction();
+  if (!callee || scalCall.getNumArgOperands() != 2 || !IsPowFunc(callee->getName())) return false;
+
+  Value & scaBase = *scalCall.getArgOperand(0);
+  Value & scaExp = *scalCall.getArgOperand(1);
+  auto * scaTy = scaBase.getType();
+  if (!scaTy->isFloatTy() && !scaTy->isDoubleTy()) return false;
+
+  const int ulpBound = GetCallSiteULPBound(scalCall, config.maxULPErrorBound);
+  const bool approxFunc = scalCall.hasApproxFunc();
+
+  IRBuilderBase::FastMathFlagGuard fmfGuard(builder);
+  builder.setFastMathFlags(scalCall.getFastMathFlags());
+
+  auto * expConst = dyn_cast<ConstantFP>(&scaExp);
+  double exponent = expConst ? GetDoubleValue(*expConst) : 0.0;
+
+  // integer exponent: square-and-multiply chain
+  if (expConst && std::trunc(exponent) == exponent && std::fabs(exponent) <= MaxPowChainExponent) {
+    int intExp = (int) exponent;
+    unsigned absExp = std::abs(intExp);
+
+    // 1 / x^n may lose all precision if x^n under- or overflows (except for n == 1)
+    bool reciprocal = intExp < 0;
+    if (reciprocal && absExp > 1 && !approxFunc) return false;
+    int chainError = GetPowChainError(absExp) + (reciprocal ? 5 : 0);
+    if (chainError > ulpBound) return false;
+
+    Value * vecBase = requestVectorValue(&scaBase);
+    Value * result = vecBase;
+    if (absExp == 0) {
+      result = getSplat(ConstantFP::get(scaTy, 1.0));
+    } else {
+      for (int bit = (int) Log2_32(absExp) - 1; bit >= 0; --bit) {
+        result = builder.CreateFMul(result, result, scalCall.getName() + ".sq");
+        if (absExp & (1u << bit)) result = builder.CreateFMul(result, vecBase, scalCall.getName() + ".mul");
+      }
+    }
+    if (reciprocal) result = builder.CreateFDiv(getSplat(ConstantFP::get(scaTy, 1.0)), result, scalCall.getName() + ".rcp");
+
+    mapVectorValue(&scalCall, result);
+    ++numSpecializedCalls;
+    return true;
+  }
+
+  // exp2(y * log2(x)) only if an approximation will do and it has the same special cases as pow:
+  // - a constant non-integer exponent (pow of a negative base is NaN, pow(0, k) is 0 or inf).
+  // - a positive and finite constant base other than 1 (pow(1, inf) is 1).
+  if (!approxFunc) return false;
+  auto * baseConst = dyn_cast<ConstantFP>(&scaBase);
+  bool positiveBase = baseConst && !baseConst->isNegative() && baseConst->getValueAPF().isFiniteNonZero() && !baseConst->isExactlyValue(1.0);
+  bool nonIntegerExp = expConst && expConst->getValueAPF().isFiniteNonZero() && std::trunc(exponent) != exponent;
+  if (!positiveBase && !nonIntegerExp) return false;
+
+  bool isFloat = scaTy->isFloatTy();
+  auto * unaryTy = FunctionType::get(scaTy, {scaTy}, false);
+  VectorShapeVec varyingArgShapes = {VectorShape::varying()};
+  auto expResolver = platInfo.getResolver(isFloat ? "exp2f" : "exp2", *unaryTy, varyingArgShapes, vectorWidth(), hasCallPredicate, ulpBound);
+  if (!expResolver || expResolver->getMaskPos() >= 0) return false;
+
+  Value * vecLog = nullptr;
+  if (positiveBase) {
+    // log2 of the constant base is folded
+    vecLog = getSplat(ConstantExpr::getFPCast(ConstantFP::get(builder.getDoubleTy(), std::log2(GetDoubleValue(*baseConst))), scaTy));
+  } else {
+    auto logResolver = platInfo.getResolver(isFloat ? "log2f" : "log2", *unaryTy, varyingArgShapes, vectorWidth(), hasCallPredicate, ulpBound);
+    if (!logResolver || logResolver->getMaskPos() >= 0) return false;
+    Function & logFunc = logResolver->requestVectorized();
+    CopyTargetAttributes(logFunc, vecInfo.getScalarFunction());
+    vecLog = builder.CreateCall(&logFunc, {requestVectorValue(&scaBase)}, scalCall.getName() + ".log2");
+  }
+
+  Function & expFunc = expResolver->requestVectorized();
+  CopyTargetAttributes(expFunc, vecInfo.getScalarFunction());
+
+  Value * vecExp = expConst ? getSplat(expConst) : requestVectorValue(&scaExp);
+  auto * vecScaled = builder.CreateFMul(vecLog, vecExp, scalCall.getName() + ".scaled");
+  auto * vecPow = builder.CreateCall(&expFunc, {vecScaled}, scalCall.getName() + ".exp2");
+
+  mapVectorValue(&scalCall, vecPow);
+  ++numSpecializedCalls;
+  return true;
+}
+
 void
 NatBuilder::vectorizeCallInstruction(CallInst *const scalCall) {
   auto & scaBlock = *scalCall->getParent();
   bool hasCallPredicate = !hasUniformPredicate(scaBlock);
 
+  // already computed by a fused sin/cos call
+  if (getVectorValue(*scalCall)) return;
+  if (config.enableSinCosFusion && vectorizeSinCosPair(*scalCall, hasCallPredicate)) return;
+  if (config.enablePowSpecialization && vectorizePowCall(*scalCall, hasCallPredicate)) return;
+
   Value * callee = scalCall->getCalledOperand();
   StringRef calleeName = callee->getName();
   Function * calledFunction = dyn_cast<Function>(callee);
@@ -1321,10 +1860,13 @@ NatBuilder::vectorizeCallInstruction(CallInst *const scalCall) {
     }
   }
 
+// the precision this call site requires (fast-math flags, !fpmath)
+  const int callULPBound = GetCallSiteULPBound(*scalCall, config.maxULPErrorBound);
+
 // Vectorize this function using a resolver provided vector function.
   auto & scaMask = *vecInfo.getPredicate(scaBlock);
   std::unique_ptr<FunctionResolver> funcResolver = nullptr;
-  if (calledFunction) funcResolver = platInfo.getResolver(calledFunction->getName(), *calledFunction->getFunctionType(), callArgShapes, vectorWidth(), hasCallPredicate);
+  if (calledFunction) funcResolver = platInfo.getResolver(calledFunction->getName(), *calledFunction->getFunctionType(), callArgShapes, vectorWidth(), hasCallPredicate, callULPBound);
   if (funcResolver && !CheckFlag("RV_SPLIT")) {
     Function &simdFunc = funcResolver->requestVectorized();
     CopyTargetAttributes(simdFunc, vecInfo.getScalarFunction());
@@ -1360,7 +1902,7 @@ NatBuilder::vectorizeCallInstruction(CallInst *const scalCall) {
     std::unique_ptr<FunctionResolver> funcResolver = nullptr;
     for (; calledFunction && vecWidth >= 2; vecWidth /= 2) {
       // FIXME update alignment in callArgShapes
-      funcResolver = platInfo.getResolver(calleeName, *calledFunction->getFunctionType(), callArgShapes, vecWidth, hasCallPredicate);
+      funcResolver = platInfo.getResolver(calleeName, *calledFunction->getFunctionType(), callArgShapes, vecWidth, hasCallPredicate, callULPBound);
       if (funcResolver) break;
     }
     bool replicate = !funcResolver;
@@ -1412,7 +1954,6 @@ NatBuilder::vectorizeCallInstruction(CallInst *const scalCall) {
     Value *predicate = vecInfo.getPredicate(*scalCall->getParent());
     assert(predicate && "expected predicate!");
     assert(predicate->getType()->isIntegerTy(1) && "predicate must be i1 type!");
-    bool needCascade = !isa<Constant>(predicate) && scalCall->mayHaveSideEffects();
 
     // scalar replication function
     auto replFunc = [this,scalCall](IRBuilder<> & builder, size_t lane) -> Value* {
@@ -1425,15 +1966,23 @@ NatBuilder::vectorizeCallInstruction(CallInst *const scalCall) {
     Type *callType = scalCall->getType();
     bool packResult = IsVectorizableTy(*callType);
 
-    ValVec resVec;
-    if (needCascade) {
-      resVec = scalarizeCascaded(*scalCall->getParent(), *scalCall, packResult, replFunc);
-    } else {
-      resVec = scalarize(*scalCall->getParent(), *scalCall, packResult, replFunc);
+    // calls with side effects must not execute for inactive lanes
+    bool needsGuard = scalCall->mayHaveSideEffects();
+    auto mode = hasAllTruePredicate(*scalCall->getParent()) ? ScalarizeMode::Unguarded : pickScalarizeMode(*scalCall, packResult, needsGuard);
+    switch (mode) {
+      case ScalarizeMode::Cascade:
+        scalarizeCascaded(*scalCall->getParent(), *scalCall, packResult, replFunc);
+        ++numCascadeCalls;
+        break;
+      case ScalarizeMode::ActiveLanes:
+        scalarizeActiveLanes(*scalCall->getParent(), *scalCall, packResult);
+        ++numLaneLoopCalls;
+        break;
+      case ScalarizeMode::Unguarded:
+        scalarize(*scalCall->getParent(), *scalCall, packResult, replFunc);
+        ++numFallCalls;
+        break;
     }
-
-    // if we need cascading, we need the vectorized predicate and the cascading blocks
-    needCascade ? ++numCascadeCalls : ++numFallCalls;
   }
 }
 
@@ -1487,6 +2036,81 @@ NatBuilder::matchMemoryReduction(Value * scaPtr, Value * scaValue, Value *& oPay
    return RedKind::Top;
 }
 
+RedKind
+NatBuilder::matchHistogramUpdate(StoreInst & store, Value *& oPayload, Instruction *& oScaLoad) {
+  Value * payload = nullptr;
+  Instruction * scaLoad = nullptr;
+  RedKind redKind = matchMemoryReduction(store.getPointerOperand(), store.getValueOperand(), payload, scaLoad);
+  if (redKind == RedKind::Top || redKind == RedKind::Bot) return RedKind::Top;
+
+  // the loaded value only feeds the update
+  auto * updateInst = cast<Instruction>(store.getValueOperand());
+  if (!scaLoad->hasOneUse() || !updateInst->hasOneUse()) return RedKind::Top;
+
+  // the loaded value is still current when the store happens
+  if (scaLoad->getParent() != store.getParent()) return RedKind::Top;
+  for (auto * inst = scaLoad->getNextNode(); inst != &store; inst = inst->getNextNode()) {
+    if (inst->mayWriteToMemory()) return RedKind::Top;
+  }
+
+  oPayload = payload;
+  oScaLoad = scaLoad;
+  return redKind;
+}
+
+Value *
+NatBuilder::createHistogramStore(RedKind redKind, Type *vecType, llvm::Align alignment, Value *vecPtr, Value *vecOldVal, Value *vecPayload, Value *mask) {
+  const int vecWidth = vectorWidth();
+  auto & ctx = builder.getContext();
+  auto * elemTy = cast<VectorType>(vecType)->getElementType();
+  auto * neutralVec = getSplat(&GetNeutralElement(redKind, *elemTy));
+  auto * falseVec = getSplat(ConstantInt::getFalse(ctx));
+
+  auto * intPtrTy = layout.getIntPtrType(ctx);
+  auto * addrVec = builder.CreatePtrToInt(vecPtr, getVectorType(intPtrTy, vecWidth), "hist_addr");
+  auto * payloadVec = builder.CreateSelect(mask, vecPayload, neutralVec, "hist_payload");
+
+  // with conflict detection, vpconflict tells which earlier lanes share the address
+  bool useConflictDetection = config.useAVX512CD && vecWidth == 8 && intPtrTy->getIntegerBitWidth() == 64;
+
+// the first lane of each address folds in the updates of all later lanes with the same address
+  Value * combined = payloadVec;
+  Value * hasEarlier = falseVec;
+  for (int r = 1; r < vecWidth; ++r) {
+    // lane i looks at lane i + r (out-of-range lanes read the second shuffle operand)
+    SmallVector<int, 16> laterIndices, earlierIndices;
+    for (int i = 0; i < vecWidth; ++i) {
+      laterIndices.push_back(i + r < vecWidth ? i + r : vecWidth + i);
+      earlierIndices.push_back(i >= r ? i - r : vecWidth + i);
+    }
+    auto * laterAddr = builder.CreateShuffleVector(addrVec, addrVec, laterIndices, "hist_addr");
+    auto * laterMask = builder.CreateShuffleVector(mask, falseVec, laterIndices, "hist_mask");
+    auto * laterPayload = builder.CreateShuffleVector(payloadVec, neutralVec, laterIndices, "hist_payload");
+    auto * conflict = builder.CreateAnd(builder.CreateICmpEQ(addrVec, laterAddr), laterMask, "hist_conflict");
+    combined = &CreateReductInst(builder, redKind, *combined, *builder.CreateSelect(conflict, laterPayload, neutralVec));
+
+    if (!useConflictDetection) {
+      // lane i + r has an earlier active lane (lane i) with the same address
+      auto * activeConflict = builder.CreateAnd(conflict, mask, "hist_active_conflict");
+      hasEarlier = builder.CreateOr(hasEarlier, builder.CreateShuffleVector(activeConflict, falseVec, earlierIndices), "hist_earlier");
+    }
+  }
+
+  if (useConflictDetection) {
+    auto & mod = *builder.GetInsertBlock()->getModule();
+    auto * conflictFunc = Intrinsic::getDeclaration(&mod, Intrinsic::x86_avx512_conflict_q_512);
+    auto * conflictBits = builder.CreateCall(conflictFunc, {addrVec}, "hist_vpconflict");
+    auto * activeBits = builder.CreateZExt(builder.CreateBitCast(mask, builder.getInt8Ty()), builder.getInt64Ty());
+    auto * activeConflicts = builder.CreateAnd(conflictBits, builder.CreateVectorSplat(vecWidth, activeBits));
+    hasEarlier = builder.CreateICmpNE(activeConflicts, getSplat(builder.getInt64(0)), "hist_earlier");
+  }
+
+// gather (already loaded), combine, scatter from the first lane of every address
+  auto * leaderMask = builder.CreateAnd(mask, builder.CreateNot(hasEarlier), "hist_leaders");
+  auto & updatedVec = CreateReductInst(builder, redKind, *vecOldVal, *combined);
+  return createVaryingMemory(vecType, alignment, vecPtr, leaderMask, &updatedVec, 1.0);
+}
+
 static Value*
 GetUnderlyingAlloca(Value * ptr) {
   std::set<Value*> seen;
@@ -1535,13 +2159,23 @@ void NatBuilder::vectorizeMemoryInstruction(Instruction *const inst) {
   Value *mask = nullptr;
   Value *predicate = vecInfo.getPredicate(*inst->getParent());
   assert(predicate && predicate->getType()->isIntegerTy(1) && "predicate must have i1 type!");
-  bool needsMask = predicate && !vecInfo.getVectorShape(*predicate).isUniform();
+  bool needsMask = predicate && !vecInfo.getVectorShape(*predicate).isUniform() && !hasAllTruePredicate(*inst->getParent());
 
   // uniform loads from allocations do not need a mask!
   if (needsMask && load && GetUnderlyingAlloca(accessedPtr)) {
     needsMask = false;
   }
 
+  // contiguous accesses to dereferenceable memory do not need a mask either:
+  // inactive lanes of a masked load are undefined anyway, stores write back the old contents in inactive lanes (if enabled)
+  uint64_t byteSize = static_cast<uint64_t>(layout.getTypeStoreSize(accessedType));
+  Value *blendMask = nullptr;
+  if (needsMask && (addrShape.isContiguous() || addrShape.isStrided(byteSize)) && (load || config.enableBlendStores) &&
+      isDereferenceableVector(*inst, *accessedPtr, byteSize)) {
+    if (store) blendMask = requestVectorValue(predicate);
+    needsMask = false;
+  }
+
   if (needsMask)
     mask = requestVectorValue(predicate);
   else
@@ -1550,15 +2184,18 @@ void NatBuilder::vectorizeMemoryInstruction(Instruction *const inst) {
   // generate the address for the memory instruction now
   // uniform: uniform GEP
   // contiguous: contiguous GEP
-  // interleaved: multiple contiguous GEPs
+  // interleaved: GEP to the start of the group window
   // varying: varying vector GEP
 
   std::vector<Value *> addr;
   std::vector<Value *> srcs;
+  std::vector<Value *> srcPreds;
   std::vector<Value *> masks;
   MaybeAlign alignment;
   bool interleaved = false;
-  uint64_t byteSize = static_cast<uint64_t>(layout.getTypeStoreSize(accessedType));
+
+  // reverse contiguous access (eg a down-counting loop): wide access plus a reversing shuffle
+  bool reversed = addrShape.isStrided(-static_cast<int>(byteSize)) && !(needsMask && !config.enableMaskedMove);
 
   if (addrShape.isUniform()) {
     // scalar access
@@ -1573,16 +2210,33 @@ void NatBuilder::vectorizeMemoryInstruction(Instruction *const inst) {
     addr.push_back(builder.CreatePointerCast(ptr, vecPtrType, "vec_cast"));
     alignment = MaybeAlign(addrShape.getAlignmentFirst());
 
-  } else if ((addrShape.isStrided() && isInterleaved(inst, accessedPtr, byteSize, srcs)) && !(needsMask && !config.enableMaskedMove)) {
-    // interleaved access. ptrs: base, base+vector, base+2vector, ...
-    Value *srcPtr = getPointerOperand(cast<Instruction>(srcs[0]));
-    for (unsigned i = 0; i < srcs.size(); ++i) {
-      Value *ptr = requestInterleavedAddress(srcPtr, i, vecType);
-      addr.push_back(ptr);
-      if (needsMask)
-        masks.push_back(mask);
+  } else if (reversed) {
+    // the vector starts at the address of the last lane
+    Value *ptr = requestScalarValue(accessedPtr);
+    auto & ptrTy = *cast<PointerType>(ptr->getType());
+    PointerType *vecPtrType = vecType->getPointerTo(ptrTy.getAddressSpace());
+    Value *lastPtr = builder.CreateGEP(accessedType, ptr, ConstantInt::getSigned(i32Ty, 1 - (int) vectorWidth()), "rev_base");
+    addr.push_back(builder.CreatePointerCast(lastPtr, vecPtrType, "vec_cast"));
+    alignment = MaybeAlign(addrShape.getAlignmentGeneral());
+
+  } else if (addrShape.isStrided() && isInterleaved(inst, accessedPtr, byteSize, srcs, srcPreds)) {
+    // interleaved access: a single wide access over the window of all group members
+    unsigned memberIdx = static_cast<unsigned>(std::find(srcs.begin(), srcs.end(), inst) - srcs.begin());
+    addr.push_back(requestInterleavedBase(accessedPtr, memberIdx));
+
+    // members are masked by their own predicate, gaps are masked off
+    for (Value *srcPred : srcPreds) {
+      if (!srcPred)
+        masks.push_back(getConstantVector(vectorWidth(), i1Ty, 0));
+      else if (vecInfo.getVectorShape(*srcPred).isUniform())
+        masks.push_back(getConstantVector(vectorWidth(), i1Ty, 1));
+      else
+        masks.push_back(requestVectorValue(srcPred));
     }
-    alignment = MaybeAlign(addrShape.getAlignmentFirst());
+
+    // the window starts memberIdx elements before this access
+    MaybeAlign memberAlignment = std::max<MaybeAlign>(MaybeAlign(addrShape.getAlignmentFirst()), load ? load->getAlign() : store->getAlign());
+    alignment = commonAlignment(memberAlignment.valueOrOne(), memberIdx * byteSize);
     interleaved = true;
 
   } else {
@@ -1591,7 +2245,8 @@ void NatBuilder::vectorizeMemoryInstruction(Instruction *const inst) {
   }
 
   MaybeAlign origAlignment = load ? load->getAlign() : store->getAlign();
-  alignment = std::max<MaybeAlign>(alignment, origAlignment);
+  if (!interleaved)
+    alignment = std::max<MaybeAlign>(alignment, origAlignment);
 
   Value *vecMem = nullptr;
   if (load) {
@@ -1605,18 +2260,30 @@ void NatBuilder::vectorizeMemoryInstruction(Instruction *const inst) {
 
       addrShape.isUniform() ? ++numUniLoads : needsMask ? ++numContMaskedLoads : ++numContLoads;
 
-    } else if (interleaved && !(needsMask && !config.enableMaskedMove)) {
-      assert(addr.size() > 1 && "only one address for multiple accesses!");
-      createInterleavedMemory(vecType, alignment.valueOrOne(), &addr, &masks, nullptr, &srcs);
+    } else if (reversed) {
+      assert(addr.size() == 1 && "multiple addresses for single access!");
+      Value *wideLoad = createContiguousLoad(addr[0], alignment.valueOrOne(), needsMask ? createReverseVector(mask) : nullptr, UndefValue::get(vecType));
+      vecMem = createReverseVector(wideLoad);
+
+      needsMask ? ++numContMaskedLoads : ++numContLoads;
+
+    } else if (interleaved) {
+      assert(addr.size() == 1 && "multiple base addresses for interleaved access!");
+      createInterleavedMemory(vecType, alignment.valueOrOne(), addr[0], masks, srcs, false);
 
     } else {
       assert(addr.size() == 1 && "multiple addresses for single access!");
-      vecMem = createVaryingMemory(vecType, alignment.valueOrOne(), addr[0], mask, nullptr);
+      vecMem = createVaryingMemory(vecType, alignment.valueOrOne(), addr[0], mask, nullptr, vecInfo.getLaneDensity(*inst->getParent()));
     }
 
 
   } else {
     // store
+    // histogram update "*varyingPtr += varyingValue" (lanes may access the same address)
+    Value * histPayload = nullptr;
+    Instruction * histLoad = nullptr;
+    RedKind histKind = addrShape.isVarying() ? matchHistogramUpdate(*store, histPayload, histLoad) : RedKind::Top;
+
     if (needsMask && addrShape.isUniform()) {
       assert(addr.size() == 1 && "multiple addresses for single access!");
       auto valShape = vecInfo.getVectorShape(*store->getValueOperand());
@@ -1654,26 +2321,35 @@ void NatBuilder::vectorizeMemoryInstruction(Instruction *const inst) {
         mappedStoredVal = addrShape.isUniform() ? requestScalarValue(storedValue)
                                                 : requestVectorValue(storedValue);
       }
+      if (blendMask) {
+        // load-blend-store
+        Value *oldVal = createContiguousLoad(addr[0], alignment.valueOrOne(), nullptr, UndefValue::get(vecType));
+        mappedStoredVal = builder.CreateSelect(blendMask, mappedStoredVal, oldVal, "blend_store");
+      }
       vecMem = createContiguousStore(mappedStoredVal, addr[0], alignment.valueOrOne(), needsMask ? mask : nullptr);
 
       addrShape.isUniform() ? ++numUniStores : needsMask ? ++numContMaskedStores : ++numContStores;
 
-    } else if (interleaved && !(needsMask && !config.enableMaskedMove)) {
-      assert(addr.size() > 1 && "only one address for multiple accesses!");
-      std::vector<Value *> vals;
-      vals.reserve(addr.size());
-      for (unsigned i = 0; i < addr.size(); ++i) {
-        Value *srcVal = cast<StoreInst>(srcs[i])->getValueOperand();
-        Value *val = requestVectorValue(srcVal);
-        vals.push_back(val);
-      }
-      createInterleavedMemory(vecType, alignment.valueOrOne(), &addr, &masks, &vals, &srcs);
+    } else if (reversed) {
+      assert(addr.size() == 1 && "multiple addresses for single access!");
+      Value *mappedStoredVal = createReverseVector(requestVectorValue(storedValue));
+      vecMem = createContiguousStore(mappedStoredVal, addr[0], alignment.valueOrOne(), needsMask ? createReverseVector(mask) : nullptr);
+
+      needsMask ? ++numContMaskedStores : ++numContStores;
+
+    } else if (interleaved) {
+      assert(addr.size() == 1 && "multiple base addresses for interleaved access!");
+      createInterleavedMemory(vecType, alignment.valueOrOne(), addr[0], masks, srcs, true);
+
+    } else if (histKind != RedKind::Top) {
+      assert(addr.size() == 1 && "multiple addresses for single access!");
+      vecMem = createHistogramStore(histKind, vecType, alignment.valueOrOne(), addr[0], requestVectorValue(histLoad), requestVectorValue(histPayload), mask);
 
     } else {
       assert(addr.size() == 1 && "multiple addresses for single access!");
       Value *mappedStoredVal = addrShape.isUniform() ? requestScalarValue(storedValue)
                                                        : requestVectorValue(storedValue);
-      vecMem = createVaryingMemory(vecType, alignment.valueOrOne(), addr[0], mask, mappedStoredVal);
+      vecMem = createVaryingMemory(vecType, alignment.valueOrOne(), addr[0], mask, mappedStoredVal, vecInfo.getLaneDensity(*inst->getParent()));
     }
   }
 
@@ -1840,74 +2516,156 @@ Value *NatBuilder::createUniformMaskedMemory(Instruction *inst, Type *accessedTy
 }
 
 Value *NatBuilder::createVaryingMemory(Type *vecType, llvm::Align alignment, Value *addr, Value *mask,
-                                       Value *values) {
+                                       Value *values, double laneDensity) {
   bool scatter(values != nullptr);
   bool maskNonConst(!isa<ConstantVector>(mask));
   maskNonConst ? (scatter ? ++numMaskedScatter : ++numMaskedGather) : (scatter ? ++numScatter : ++numGather);
 
-  if (config.useScatterGatherIntrinsics) {
-    auto * vecPtrTy = addr->getType();
-
-    std::vector<Value *> args;
-    if (scatter) args.push_back(values);
-    args.push_back(addr);
-    args.push_back(ConstantInt::get(i32Ty, alignment.value()));
-    args.push_back(mask);
-    if (!scatter) args.push_back(UndefValue::get(vecType));
-    Module *mod = vecInfo.getMapping().vectorFn->getParent();
-    Function *intr = scatter ? Intrinsic::getDeclaration(mod, Intrinsic::masked_scatter, {vecType, vecPtrTy})
-                             : Intrinsic::getDeclaration(mod, Intrinsic::masked_gather, {vecType, vecPtrTy});
-    assert(intr && "scatter/gather not found!");
-    return builder.CreateCall(intr, args);
+  if (!isa<Constant>(mask) && preferSafeAddressAccess(vecType, alignment, addr, mask, scatter, laneDensity)) {
+    // redirect inactive lanes to a scratch slot and access all lanes
+    auto * elemPtrTy = cast<PointerType>(cast<VectorType>(addr->getType())->getElementType());
+    auto * slot = requestScratchSlot(elemPtrTy->getElementType(), alignment);
+    auto * safeAddr = builder.CreateSelect(mask, addr, builder.CreateVectorSplat(vectorWidth(), slot), "safe_addr");
+    if (!config.useScatterGatherIntrinsics) return createLaneWiseMemory(vecType, alignment, safeAddr, values);
+    return createGatherScatter(vecType, alignment, safeAddr, getSplat(ConstantInt::getTrue(builder.getContext())), values);
+  }
 
-  } else
+  if (config.useScatterGatherIntrinsics)
+    return createGatherScatter(vecType, alignment, addr, mask, values);
+  else
     return scatter ? requestCascadeStore(values, addr, alignment.value(), mask) : requestCascadeLoad(addr, alignment.value(), mask);
 }
 
-void NatBuilder::createInterleavedMemory(Type *vecType, llvm::Align alignment, std::vector<Value *> *addr, std::vector<Value *> *masks,
-                                         std::vector<Value *> *values, std::vector<Value *> *srcs) {
+Value *NatBuilder::createGatherScatter(Type *vecType, llvm::Align alignment, Value *addr, Value *mask, Value *values) {
+  bool scatter(values != nullptr);
+  auto * vecPtrTy = addr->getType();
 
-  unsigned stride = (unsigned) addr->size();
-  bool needsMask = masks->size() > 0;
-  bool load = values == nullptr;
+  std::vector<Value *> args;
+  if (scatter) args.push_back(values);
+  args.push_back(addr);
+  args.push_back(ConstantInt::get(i32Ty, alignment.value()));
+  args.push_back(mask);
+  if (!scatter) args.push_back(UndefValue::get(vecType));
+  Module *mod = vecInfo.getMapping().vectorFn->getParent();
+  Function *intr = scatter ? Intrinsic::getDeclaration(mod, Intrinsic::masked_scatter, {vecType, vecPtrTy})
+                           : Intrinsic::getDeclaration(mod, Intrinsic::masked_gather, {vecType, vecPtrTy});
+  assert(intr && "scatter/gather not found!");
+  return builder.CreateCall(intr, args);
+}
 
-  // tranpose mask and values if needed
-  ShuffleBuilder maskTransposer(vectorWidth());
-  if (needsMask)
-    maskTransposer.add(*masks);
+Value *NatBuilder::createLaneWiseMemory(Type *vecType, llvm::Align alignment, Value *addr, Value *values) {
+  bool store(values != nullptr);
+  Value *resVec = store ? nullptr : UndefValue::get(vecType);
+  Instruction *lastStore = nullptr;
+  for (int i = 0; i < vectorWidth(); ++i) {
+    auto * laneIdx = ConstantInt::get(i32Ty, i);
+    auto * lanePtr = builder.CreateExtractElement(addr, laneIdx, "safe_ptr_lane");
+    if (store) {
+      auto * laneVal = builder.CreateExtractElement(values, laneIdx, "safe_val_lane");
+      lastStore = builder.CreateAlignedStore(laneVal, lanePtr, alignment);
+    } else {
+      auto * laneLoad = builder.CreateAlignedLoad(cast<VectorType>(vecType)->getElementType(), lanePtr, alignment, "safe_load_lane");
+      resVec = builder.CreateInsertElement(resVec, laneLoad, laneIdx, "safe_load");
+    }
+  }
+  return store ? lastStore : resVec;
+}
 
-  // build interleaved loads/stores
-  Value *vecMem;
-  ShuffleBuilder transposer(vectorWidth());
-  if (!load)
-    transposer.add(*values);
+bool NatBuilder::preferSafeAddressAccess(Type *vecType, llvm::Align alignment, Value *addr, Value *mask, bool scatter, double laneDensity) {
+  if (!config.useSafeAddressGather) return false;
 
-  for (unsigned i = 0; i < stride; ++i) {
-    Value *ptr = (*addr)[i];
-    Value *mask = needsMask ? maskTransposer.shuffleToInterleaved(builder, stride, i) : nullptr;
+  // the scratch slot lives on the stack
+  auto * elemPtrTy = cast<PointerType>(cast<VectorType>(addr->getType())->getElementType());
+  if (elemPtrTy->getAddressSpace() != layout.getAllocaAddrSpace()) return false;
 
-    if (masks->size() == 1 && i == (stride - 1)) {
-      needsMask = true;
-      mask = masks->front();
-    }
+  // without cost information only replace the per-lane cascade
+  auto * tti = platInfo.getTTI();
+  if (!tti) return !config.useScatterGatherIntrinsics;
 
-    if (load) {
-      vecMem = createContiguousLoad(ptr, alignment, mask, UndefValue::get(vecType));
-      transposer.add(vecMem);
-    } else {
-      Value *val = transposer.shuffleToInterleaved(builder, stride, i);
-      vecMem = createContiguousStore(val, ptr, alignment, mask);
-      if (i < srcs->size())
-        mapVectorValue((*srcs)[i], vecMem);
-    }
+  // the target masks gathers/scatters natively (AVX-512)
+  bool nativeMasked = scatter ? tti->isLegalMaskedScatter(vecType, alignment) : tti->isLegalMaskedGather(vecType, alignment);
+  if (config.useScatterGatherIntrinsics && nativeMasked) return false;
+
+  const auto costKind = TargetTransformInfo::TCK_RecipThroughput;
+  unsigned opcode = scatter ? Instruction::Store : Instruction::Load;
+  int selectCost = tti->getCmpSelInstrCost(Instruction::Select, addr->getType(), mask->getType(), costKind);
+
+  // an unmasked gather/scatter can be lowered without a branch per lane
+  if (config.useScatterGatherIntrinsics) {
+    int safeCost = selectCost + tti->getGatherScatterOpCost(opcode, vecType, addr, false, alignment, costKind);
+    int maskedCost = tti->getGatherScatterOpCost(opcode, vecType, addr, true, alignment, costKind);
+    return safeCost <= maskedCost;
   }
-  if (load) {
-    // de-interleave and map
+
+  // Otw, the unguarded lane-wise access (all lanes) replaces the cascade (mask test and branch per lane, access on active lanes)
+  auto * elemTy = cast<VectorType>(vecType)->getElementType();
+  const double numLanes = vectorWidth();
+  const double numActive = laneDensity * numLanes;
+  int laneAccessCost = tti->getMemoryOpCost(opcode, elemTy, alignment, elemPtrTy->getAddressSpace(), costKind);
+  laneAccessCost += tti->getVectorInstrCost(Instruction::ExtractElement, addr->getType(), 0);
+  laneAccessCost += tti->getVectorInstrCost(scatter ? Instruction::ExtractElement : Instruction::InsertElement, vecType, 0);
+  int laneTestCost = tti->getVectorInstrCost(Instruction::ExtractElement, mask->getType(), 0) + tti->getCFInstrCost(Instruction::Br, costKind);
+
+  double safeCost = selectCost + numLanes * laneAccessCost;
+  double cascadeCost = numLanes * laneTestCost + numActive * laneAccessCost;
+  return safeCost <= cascadeCost;
+}
+
+Value *NatBuilder::requestScratchSlot(Type *elemTy, llvm::Align alignment) {
+  auto itSlot = scratchSlots.find(elemTy);
+  AllocaInst * slot = itSlot != scratchSlots.end() ? itSlot->second : nullptr;
+  if (!slot) {
+    auto & entryBlock = vecInfo.getVectorFunction().getEntryBlock();
+    IRBuilder<> entryBuilder(&entryBlock, entryBlock.getFirstInsertionPt());
+    slot = entryBuilder.CreateAlloca(elemTy, nullptr, "safe_slot");
+    scratchSlots[elemTy] = slot;
+  }
+  if (slot->getAlign() < alignment) slot->setAlignment(alignment);
+  return slot;
+}
+
+void NatBuilder::createInterleavedMemory(Type *vecType, llvm::Align alignment, Value *basePtr, std::vector<Value *> &masks,
+                                         std::vector<Value *> &srcs, bool store) {
+  unsigned stride = (unsigned) srcs.size();
+  bool needsMask = !masks.empty();
+
+  // the window of the group: member k of lane i sits at element i * stride + k
+  Type *elemTy = cast<VectorType>(vecType)->getElementType();
+  Type *wideType = getVectorType(elemTy, vectorWidth() * stride);
+  int addrSpace = cast<PointerType>(basePtr->getType())->getAddressSpace();
+  Value *widePtr = builder.CreatePointerCast(basePtr, wideType->getPointerTo(addrSpace), "inter_cast");
+
+  // interleave the member masks the same way
+  Value *wideMask = nullptr;
+  if (needsMask) {
+    ShuffleBuilder maskInterleaver(masks, vectorWidth());
+    wideMask = maskInterleaver.interleave(builder);
+  }
+
+  if (!store) {
+    // wide load and de-interleave
+    Value *wideLoad = createContiguousLoad(widePtr, alignment, wideMask, UndefValue::get(wideType));
+    ShuffleBuilder deinterleaver(vectorWidth());
     for (unsigned i = 0; i < stride; ++i) {
-      vecMem = transposer.shuffleFromInterleaved(builder, stride, i);
-      if (i < srcs->size())
-        mapVectorValue((*srcs)[i], vecMem);
+      if (!srcs[i])
+        continue;
+      mapVectorValue(srcs[i], deinterleaver.extractStrided(builder, wideLoad, stride, i));
     }
+    needsMask ? ++numInterMaskedLoads : ++numInterLoads;
+
+  } else {
+    // interleave and wide store (gaps are masked off)
+    std::vector<Value *> values;
+    for (Value *src : srcs) {
+      values.push_back(src ? requestVectorValue(cast<StoreInst>(src)->getValueOperand()) : UndefValue::get(vecType));
+    }
+    ShuffleBuilder interleaver(values, vectorWidth());
+    Value *wideStore = createContiguousStore(interleaver.interleave(builder), widePtr, alignment, wideMask);
+    for (Value *src : srcs) {
+      if (src)
+        mapVectorValue(src, wideStore);
+    }
+    needsMask ? ++numInterMaskedStores : ++numInterStores;
   }
 }
 
@@ -1922,6 +2680,14 @@ Value *NatBuilder::createContiguousStore(Value *val, Value *ptr, llvm::Align ali
   }
 }
 
+Value *NatBuilder::createReverseVector(Value *vec) {
+  SmallVector<int, 16> revIndices;
+  for (int i = vectorWidth() - 1; i >= 0; --i) {
+    revIndices.push_back(i);
+  }
+  return builder.CreateShuffleVector(vec, UndefValue::get(vec->getType()), revIndices, "reverse");
+}
+
 Value *NatBuilder::createContiguousLoad(Value *ptr, llvm::Align alignment, Value *mask, Value *passThru) {
   if (mask) {
     return builder.CreateMaskedLoad(ptr, alignment, mask, passThru, "cont_load");
@@ -2358,82 +3124,18 @@ Value *NatBuilder::requestScalarBitCast(llvm::BitCastInst *const bc, unsigned la
   return mapped;
 }
 
-llvm::Value*
-NatBuilder::requestInterleavedGEP(GetElementPtrInst *const gep, unsigned interleavedIdx) {
-  assert(gep->getNumOperands() - 1 == gep->getNumIndices() && "llvm implementation for GEP changed!");
-
-  // first, we need a vectorized base vecValue (or scalar if all_uniform). then, we have to calculate the indices
-  // we need vector values if something is not all_uniform. we need to extract an dimension if !buildAllDimensions
-  Value *scalBasePtr = gep->getPointerOperand();
-  Value *basePtr = requestScalarValue(scalBasePtr);
-  Type *st = isStructAccess(gep);
-
-  std::vector<Value *> idxList;
-  idxList.reserve(gep->getNumIndices());
-  for (unsigned i = 0; i < gep->getNumIndices(); ++i) {
-    Value *idx = gep->getOperand(i + 1);
-    Value *interIdx = requestScalarValue(idx);
-    VectorShape idxShape = getVectorShape(*idx);
-
-    if (st && !idxShape.isUniform() && interleavedIdx > 0) {
-      // calculate total offset from base and size of struct (1 if no struct)
-      unsigned offset = vectorWidth() * interleavedIdx + getStructOffset(gep);
-      unsigned structSize = getNumLeafElements(st, gep->getResultElementType(), layout);
-      unsigned k = offset / structSize;
-      if (k > 0)
-        interIdx = builder.CreateAdd(interIdx, ConstantInt::get(interIdx->getType(), k), "inter_struct_idx");
-
-      idxList.push_back(interIdx);
-
-      // create the actual struct access indices
-      for (++i; i < gep->getNumIndices(); ++i) {
-        idx = gep->getOperand(i + 1);
-        assert(isa<ConstantInt>(idx) && "element access with non-constant!");
-
-        unsigned idxValue = (unsigned) cast<ConstantInt>(idx)->getLimitedValue();
-        offset %= structSize;
-        st = st->getContainedType(idxValue);
-        structSize = getNumLeafElements(st, gep->getResultElementType(), layout);
-        k = offset / structSize;
-
-        idxList.push_back(ConstantInt::get(idx->getType(), k));
-      }
-      break;
-
-    } else if (interleavedIdx > 0 && !idxShape.isUniform()) {
-      interIdx = builder.CreateAdd(interIdx, ConstantInt::get(interIdx->getType(), vectorWidth() * interleavedIdx), "inter_idx");
-    }
-
-    idxList.push_back(interIdx);
-  }
-
-  auto *interGEP = builder.CreateGEP(basePtr, idxList, "inter_gep");
-  auto * interGEPInst = dyn_cast<GetElementPtrInst>(interGEP);
-  if (interGEPInst) interGEPInst->setIsInBounds(gep->isInBounds());
-
-  return interGEP;
-}
-
 llvm::Value *
-NatBuilder::requestInterleavedAddress(llvm::Value *const addr, unsigned interleavedIdx, Type *const vecType) {
+NatBuilder::requestInterleavedBase(llvm::Value *const addr, unsigned memberIdx) {
   ++numInterGEPs;
-  Value *interAddr = addr;
-
-  if (isa<BitCastInst>(interAddr))
-    interAddr = cast<BitCastInst>(interAddr)->getOperand(0);
 
-  if (isa<GetElementPtrInst>(interAddr))
-    interAddr = requestInterleavedGEP(cast<GetElementPtrInst>(interAddr), interleavedIdx);
+  // the interleaved window starts @memberIdx elements before the (lane 0) address of this member
+  Value *ptr = requestScalarValue(addr);
+  if (memberIdx == 0)
+    return ptr;
 
-  else {
-    Value *ptr = requestScalarValue(addr, 0, true);
-    auto * indexTy = getIndexTy(ptr);
-    interAddr = builder.CreateGEP(ptr, ConstantInt::get(indexTy, vectorWidth() * interleavedIdx), "inter_gep");
-  }
-
-  int AddrSpace = cast<PointerType>(addr->getType())->getAddressSpace();
-  PointerType *vecPtrType = vecType->getPointerTo(AddrSpace);
-  return builder.CreatePointerCast(interAddr, vecPtrType, "inter_cast");
+  Type *elemTy = cast<PointerType>(addr->getType())->getElementType();
+  auto * indexTy = getIndexTy(ptr);
+  return builder.CreateGEP(elemTy, ptr, ConstantInt::getSigned(indexTy, -static_cast<int64_t>(memberIdx)), "inter_base");
 }
 
 llvm::Value *
@@ -2651,13 +3353,20 @@ Value *NatBuilder::createPTest(Value *vector, bool isRv_all) {
 }
 
 bool
-NatBuilder::hasUniformPredicate(const BasicBlock & BB) const {
+NatBuilder::hasUniformPredicate(const BasicBlock & BB) {
+  if (!vecInfo.getRegion().contains(&BB) || !vecInfo.getPredicate(BB)) return true;
+  else return vecInfo.getVectorShape(*vecInfo.getPredicate(BB)).isUniform() || hasAllTruePredicate(BB);
+}
+
+bool
+NatBuilder::hasAllTruePredicate(const BasicBlock & BB) {
   if (!vecInfo.getRegion().contains(&BB) || !vecInfo.getPredicate(BB)) return true;
-  else return vecInfo.getVectorShape(*vecInfo.getPredicate(BB)).isUniform();
+  else return allTrueMasks.isAllTrue(*vecInfo.getPredicate(BB), BB);
 }
 
 Value*
 NatBuilder::requestVectorPredicate(const BasicBlock& scaBlock) {
+  if (hasAllTruePredicate(scaBlock)) return getConstantVector(vectorWidth(), i1Ty, 1);
   return requestVectorValue(vecInfo.getPredicate(scaBlock));
 }
 
@@ -2751,12 +3460,11 @@ NatBuilder::materializeStridePattern(rv::StridePattern & sp) {
   auto & vecReductor = *getScalarValueAs<Instruction>(*sp.reductor, 0);
 
   // create an adjusted reductor (full SIMD stride)
+  // scale the constant increment (add/sub operand, gep index) by the vector width
   auto * clonedReductor = cast<Instruction>(vecReductor.clone());
-  int vecStride = vectorWidth * redShape.getStride();
-  auto & vecConst = *ConstantInt::getSigned(sp.phi->getType(), vecStride);
-
-  // FIXME rematerialize reductor instead (currently unsount wrt to sub)
   int constIdx = isa<Constant>(sp.reductor->getOperand(0)) ? 0 : 1;
+  auto & scaConst = *cast<ConstantInt>(sp.reductor->getOperand(constIdx));
+  auto & vecConst = *ConstantInt::getSigned(scaConst.getType(), vectorWidth * scaConst.getSExtValue());
   clonedReductor->setOperand(constIdx, &vecConst);
   clonedReductor->insertAfter(&vecReductor);
 
@@ -2776,8 +3484,7 @@ NatBuilder::materializeStridePattern(rv::StridePattern & sp) {
                       auto * insertPt = userBlock.getFirstNonPHI();
                       IRBuilder<> builder(&userBlock, insertPt->getIterator());
 
-                      auto * liveOutView = builder.CreateAdd(&usedVal, ConstantInt::getSigned(usedVal.getType(), amount), ".red");
-                      return *liveOutView;
+                      return sp.createOffset(builder, usedVal, amount, ".red");
                     }
   );
 
@@ -2788,8 +3495,7 @@ NatBuilder::materializeStridePattern(rv::StridePattern & sp) {
                       auto * insertPt = userBlock.getFirstNonPHI();
                       IRBuilder<> builder(&userBlock, insertPt->getIterator());
 
-                      auto * liveOutView = builder.CreateAdd(&usedVal, ConstantInt::getSigned(usedVal.getType(), amount), ".red");
-                      return *liveOutView;
+                      return sp.createOffset(builder, usedVal, amount, ".red");
                     }
   );
 }
@@ -2995,6 +3701,145 @@ NatBuilder::materializeVaryingReduction(Reduction & red, PHINode & scaPhi) {
   }
 }
 
+void
+NatBuilder::materializeScan(Reduction & red, PHINode & scaPhi) {
+  assert((red.kind != RedKind::Top) && (red.kind != RedKind::Bot));
+
+  const int vectorWidth = vecInfo.getVectorWidth();
+  auto * vecPhi = getVectorValueAs<PHINode>(scaPhi);
+
+  auto * inAtZero = dyn_cast<Instruction>(scaPhi.getIncomingValue(0));
+  int latchIdx = (inAtZero && vecInfo.inRegion(*inAtZero)) ? 0 : 1;
+  int initIdx = 1 - latchIdx;
+
+  BasicBlock * vecInitInputBlock = scaPhi.getIncomingBlock(initIdx);
+  BasicBlock * vecLoopInputBlock = getVectorBlock(*scaPhi.getIncomingBlock(latchIdx), true);
+
+// "s.next = s [[op]] x" (checked by the loop vectorizer)
+  auto * scaReductor = cast<Instruction>(scaPhi.getIncomingValue(latchIdx));
+  auto * vecReductor = getVectorValueAs<Instruction>(*scaReductor);
+  int phiIdx = scaReductor->getOperand(0) == &scaPhi ? 0 : 1;
+  assert(vecReductor->getOperand(phiIdx) == vecPhi);
+  auto & vecInput = *vecReductor->getOperand(1 - phiIdx);
+
+// scalar carry (running value before this vector iteration)
+  auto * carryPhi = PHINode::Create(scaPhi.getType(), 2, scaPhi.getName() + ".carry", vecPhi);
+  carryPhi->addIncoming(scaPhi.getIncomingValue(initIdx), vecInitInputBlock);
+
+// scan the input as soon as it is available
+  Instruction * insertPt = vecPhi->getParent()->getFirstNonPHI();
+  if (auto * inputInst = dyn_cast<Instruction>(&vecInput)) {
+    insertPt = isa<PHINode>(inputInst) ? inputInst->getParent()->getFirstNonPHI() : inputInst->getNextNode();
+  }
+  IRBuilder<> scanBuilder(insertPt);
+
+  auto * carrySplat = scanBuilder.CreateVectorSplat(vectorWidth, carryPhi, scaPhi.getName() + ".carry");
+  auto & inputScan = CreateVectorScan(scanBuilder, red.kind, vecInput);
+  auto & inclusiveVal = CreateReductInst(scanBuilder, red.kind, *carrySplat, inputScan);
+
+  // lane i of the phi observes the running value after lane i - 1
+  SmallVector<int, 16> shiftIndices;
+  shiftIndices.push_back(0);
+  for (int i = 1; i < vectorWidth; ++i) {
+    shiftIndices.push_back(vectorWidth + i - 1);
+  }
+  auto * exclusiveVal = scanBuilder.CreateShuffleVector(carrySplat, &inclusiveVal, shiftIndices, scaPhi.getName() + ".excl");
+
+// pass the last lane on to the next iteration
+  auto & lastVal = CreateExtract(scanBuilder, inclusiveVal, -1);
+  carryPhi->addIncoming(&lastVal, vecLoopInputBlock);
+
+// replace the lane-wise chain
+  vecReductor->replaceAllUsesWith(&inclusiveVal);
+  vecReductor->eraseFromParent();
+  mapVectorValue(scaReductor, &inclusiveVal);
+
+  vecPhi->replaceAllUsesWith(exclusiveVal);
+  vecPhi->eraseFromParent();
+  mapVectorValue(&scaPhi, exclusiveVal);
+
+// the running value after the last iteration
+  repairOutsideUses(*scaReductor,
+                    [&](Value & usedVal, BasicBlock & userBlock) ->Value& {
+                      return lastVal;
+                    }
+  );
+  repairOutsideUses(scaPhi,
+                    [&](Value & usedVal, BasicBlock & userBlock) ->Value& {
+                      auto * insertPt = userBlock.getFirstNonPHI();
+                      IRBuilder<> builder(&userBlock, insertPt->getIterator());
+                      return CreateExtract(builder, *exclusiveVal, -1);
+                    }
+  );
+}
+
+void
+NatBuilder::materializeArgReduction(Reduction & red, PHINode & scaPhi) {
+  assert(red.keyRed && (red.kind == RedKind::ArgMin || red.kind == RedKind::ArgMax));
+
+  const int vectorWidth = vecInfo.getVectorWidth();
+  auto * vecPhi = getVectorValueAs<PHINode>(scaPhi);
+
+  auto * inAtZero = dyn_cast<Instruction>(scaPhi.getIncomingValue(0));
+  int latchIdx = (inAtZero && vecInfo.inRegion(*inAtZero)) ? 0 : 1;
+  int initIdx = 1 - latchIdx;
+
+  BasicBlock * vecInitInputBlock = scaPhi.getIncomingBlock(initIdx);
+  BasicBlock * vecLoopInputBlock = getVectorBlock(*scaPhi.getIncomingBlock(latchIdx), true);
+
+// "idx.next = select c, i, idx" (checked by the reduction analysis)
+  auto * scaLatchInst = cast<SelectInst>(scaPhi.getIncomingValue(latchIdx));
+  auto * vecLatchInst = getVectorValueAs<Instruction>(*scaLatchInst);
+  auto * scaInitValue = scaPhi.getIncomingValue(initIdx);
+
+  // the scalar loop keeps the first index of the best value unless its comparison also holds on ties
+  auto & cond = cast<CmpInst>(*scaLatchInst->getCondition());
+  bool newOnTrue = scaLatchInst->getFalseValue() == &scaPhi;
+  bool lastIndexWins = CmpInst::isTrueWhenEqual(cond.getPredicate()) == newOnTrue;
+  RedKind idxKind = lastIndexWins ? RedKind::SMax : RedKind::SMin;
+
+// lanes start out with an index that loses against every actual index
+  auto & idxNeutral = GetNeutralElement(idxKind, *scaPhi.getType());
+  vecPhi->addIncoming(getSplat(&idxNeutral), vecInitInputBlock);
+  vecPhi->addIncoming(vecLatchInst, vecLoopInputBlock);
+
+// the lane-wise best values of the min/max reduction
+  PHINode * keyPhi = nullptr;
+  for (auto & inst : *scaPhi.getParent()) {
+    auto * phi = dyn_cast<PHINode>(&inst);
+    if (!phi) break;
+    if (red.keyRed->contains(*phi)) keyPhi = phi;
+  }
+  assert(keyPhi && "min/max reduction without header phi");
+  auto * scaKeyLatch = cast<Instruction>(keyPhi->getIncomingValueForBlock(scaPhi.getIncomingBlock(latchIdx)));
+  auto * vecKeyLatch = getVectorValueAs<Instruction>(*scaKeyLatch);
+  auto * scaKeyInit = keyPhi->getIncomingValueForBlock(scaPhi.getIncomingBlock(initIdx));
+  bool isFloat = keyPhi->getType()->isFloatingPointTy();
+
+// pick the first (last) index among the lanes that hold the best value
+  repairOutsideUses(*scaLatchInst,
+                    [&](Value & usedVal, BasicBlock & userBlock) ->Value& {
+                      auto * insertPt = userBlock.getFirstNonPHI();
+                      IRBuilder<> builder(&userBlock, insertPt->getIterator());
+
+                      auto & bestVal = CreateVectorReduce(config, builder, red.keyRed->kind, *vecKeyLatch, nullptr);
+                      auto * bestSplat = builder.CreateVectorSplat(vectorWidth, &bestVal);
+                      auto * isBest = isFloat ? builder.CreateFCmpOEQ(vecKeyLatch, bestSplat) : builder.CreateICmpEQ(vecKeyLatch, bestSplat);
+                      auto * candidates = builder.CreateSelect(isBest, vecLatchInst, getSplat(&idxNeutral));
+                      auto & bestIdx = CreateVectorReduce(config, builder, idxKind, *candidates, nullptr);
+
+                      // the initial value precedes all iterations
+                      Value * keepInit = nullptr;
+                      if (lastIndexWins) {
+                        keepInit = builder.CreateICmpEQ(&bestIdx, &idxNeutral);
+                      } else {
+                        keepInit = isFloat ? builder.CreateFCmpOEQ(scaKeyInit, &bestVal) : builder.CreateICmpEQ(scaKeyInit, &bestVal);
+                      }
+                      return *builder.CreateSelect(keepInit, scaInitValue, &bestIdx, scaPhi.getName() + ".arg");
+                    }
+  );
+}
+
 void NatBuilder::addValuesToPHINodes() {
   // save current insertion point before continuing
 //  auto IB = builder.GetInsertBlock();
@@ -3024,7 +3869,11 @@ void NatBuilder::addValuesToPHINodes() {
     } else if (isVectorLoopHeader && shape.isVarying() && red && red->kind != RedKind::Bot) {
       // reduction phi handling
       IF_DEBUG_NAT { errs() << "-- materializing "; red->dump(); errs() << "\n"; }
-      if (CheckFlag("RV_RED_ORDER")) {
+      if (red->keyRed) {
+        materializeArgReduction(*red, *scalPhi);
+      } else if (red->isScan()) {
+        materializeScan(*red, *scalPhi);
+      } else if (CheckFlag("RV_RED_ORDER") && red->argReds.empty()) {
         materializeOrderedReduction(*red, *scalPhi);
       } else {
         materializeVaryingReduction(*red, *scalPhi);
@@ -3209,7 +4058,8 @@ bool NatBuilder::shouldVectorize(Instruction *inst) {
 
   if (isa<GetElementPtrInst>(inst)) {
     GetElementPtrInst *gep = cast<GetElementPtrInst>(inst);
-    return !(shape.isUniform() || shape.isContiguous() || shape.isStrided((int) layout.getTypeStoreSize(gep->getResultElementType())));
+    int byteSize = (int) layout.getTypeStoreSize(gep->getResultElementType());
+    return !(shape.isUniform() || shape.isContiguous() || shape.isStrided(byteSize) || shape.isStrided(-byteSize));
   }
 
   if (isa<ReturnInst>(inst)) {
@@ -3243,7 +4093,39 @@ bool NatBuilder::shouldVectorize(Instruction *inst) {
   return false;
 }
 
-bool NatBuilder::isInterleaved(Instruction *inst, Value *accessedPtr, int byteSize, std::vector<Value *> &srcs) {
+// widest interleaved group (wider strides are left to gather/scatter)
+static const int MaxInterleavedStride = 8;
+
+bool NatBuilder::isDereferenceableVector(Instruction &inst, Value &accessedPtr, uint64_t byteSize) {
+  uint64_t vecByteSize = vectorWidth() * byteSize;
+  APInt vecSize(layout.getIndexTypeSizeInBits(accessedPtr.getType()), vecByteSize);
+  if (isDereferenceableAndAlignedPointer(&accessedPtr, llvm::Align(1), vecSize, layout, &inst, &dominatorTree))
+    return true;
+
+  // every lane accesses the same address in a block that executes with a full mask
+  for (auto *user : accessedPtr.users()) {
+    auto *userInst = dyn_cast<Instruction>(user);
+    if (!userInst || userInst == &inst || getPointerOperand(userInst) != &accessedPtr)
+      continue;
+    if (!vecInfo.inRegion(*userInst))
+      continue;
+    Type *userTy = isa<StoreInst>(userInst) ? cast<StoreInst>(userInst)->getValueOperand()->getType() : userInst->getType();
+    if (layout.getTypeStoreSize(userTy) < byteSize)
+      continue;
+    auto *userPred = dyn_cast<ConstantInt>(vecInfo.getPredicate(*userInst->getParent()));
+    if (!userPred || !userPred->isOne())
+      continue;
+    BasicBlock *userBlock = userInst->getParent();
+    if (dominatorTree.dominates(userBlock, inst.getParent()) || postDominatorTree.dominates(userBlock, inst.getParent()))
+      return true;
+  }
+
+  // loop vectorization: the address recurrence stays within the underlying object for all (rounded up) vector iterations.
+  // This is proven on the scalar loop before the remainder transformation changes its exit condition.
+  return vecInfo.isDereferenceableAccess(accessedPtr);
+}
+
+bool NatBuilder::isInterleaved(Instruction *inst, Value *accessedPtr, int byteSize, std::vector<Value *> &srcs, std::vector<Value *> &srcPreds) {
   if (!config.enableInterleaved)
     return false;
 
@@ -3251,6 +4133,14 @@ bool NatBuilder::isInterleaved(Instruction *inst, Value *accessedPtr, int byteSi
   if ((st = isStructAccess(accessedPtr)) && !isHomogeneousStruct(st, layout))
     return false;
 
+  // every lane accesses a window of stride elements
+  const VectorShape &addrShape = getVectorShape(*accessedPtr);
+  if (addrShape.getStride() % byteSize != 0)
+    return false;
+  int stride = addrShape.getStride() / byteSize;
+  if (stride <= 1 || stride > MaxInterleavedStride)
+    return false;
+
   // group memory instructions based on their dependencies
   InstructionGrouper instructionGrouper;
   instructionGrouper.add(inst, memDepRes);
@@ -3259,22 +4149,28 @@ bool NatBuilder::isInterleaved(Instruction *inst, Value *accessedPtr, int byteSi
   }
 
   InstructionGroup instrGroup = instructionGrouper.getInstructionGroup(inst);
-  if (instrGroup.size() <= 1)
-    return false;
+  std::vector<Instruction *> candidates(instrGroup.begin(), instrGroup.end());
 
-  const VectorShape &addrShape = getVectorShape(*accessedPtr);
+  // loads of other blocks in the linearized region may join the group
+  if (isa<LoadInst>(inst))
+    collectHoistableLoads(*cast<LoadInst>(inst), candidates);
+
+  if (candidates.size() <= 1)
+    return false;
 
   // group our group based on memory layout next
   MemoryAccessGrouper memoryGrouper(SE, static_cast<unsigned>(byteSize));
   std::map<Value *, const SCEV *> addrSCEVMap;
   std::map<const SCEV *, Value *> scevInstrMap;
-  for (Instruction *instr : instrGroup) {
+  for (Instruction *instr : candidates) {
+    // already part of another group
+    if (instr != inst && getVectorValue(*instr))
+      continue;
+
     Value *addrVal = getPointerOperand(instr);
     assert(addrVal && "grouped instruction was not a memory instruction!!");
-    // only group strided accesses
-    VectorShape shape = getVectorShape(*addrVal);
-    bool groupByteContiguous = shape.isStrided(static_cast<int>(layout.getTypeStoreSize(cast<PointerType>(addrVal->getType())->getElementType())));
-    if (!shape.isStrided() || groupByteContiguous)
+    // only group accesses with the same stride
+    if (!getVectorShape(*addrVal).isStrided(addrShape.getStride()))
       continue;
     const SCEV *scev = memoryGrouper.add(addrVal);
     addrSCEVMap[addrVal] = scev;
@@ -3283,18 +4179,96 @@ bool NatBuilder::isInterleaved(Instruction *inst, Value *accessedPtr, int byteSi
 
   // check if there is an interleaved memory group for our base address
   const MemoryGroup &memGroup = memoryGrouper.getMemoryGroup(addrSCEVMap[accessedPtr]);
-  int stride = addrShape.getStride() / byteSize;
-  bool hasGaps = false;
+  if (memGroup.size() > static_cast<unsigned>(stride))
+    return false; // overlaps with the window of the next lane
+
+  srcs.assign(stride, nullptr);
+  int numMembers = 0;
   for (unsigned i = 0; i < memGroup.size(); ++i) {
-    if (!memGroup[i]) {
-      hasGaps = true;
-      break;
+    if (!memGroup[i])
+      continue;
+    srcs[i] = scevInstrMap[memGroup[i]];
+    ++numMembers;
+  }
+  if (numMembers <= 1 || std::find(srcs.begin(), srcs.end(), inst) == srcs.end())
+    return false;
+
+  // loads from a dereferenceable window do not need a mask
+  srcPreds.clear();
+  if (isa<LoadInst>(inst) && srcs[0]) {
+    Value *windowPtr = getPointerOperand(cast<Instruction>(srcs[0]));
+    APInt windowSize(layout.getIndexTypeSizeInBits(windowPtr->getType()), vectorWidth() * stride * byteSize);
+    if (isDereferenceableAndAlignedPointer(windowPtr, llvm::Align(1), windowSize, layout, inst, &dominatorTree))
+      return true;
+  }
+
+  // otherwise every member is masked with its block predicate and gaps are masked off
+  bool needsMask = numMembers < stride;
+  for (Value *src : srcs) {
+    if (!src) {
+      srcPreds.push_back(nullptr);
+      continue;
     }
-    srcs.push_back(scevInstrMap[memGroup[i]]);
+    BasicBlock &srcBlock = *cast<Instruction>(src)->getParent();
+    Value *pred = vecInfo.getPredicate(srcBlock);
+    bool varyingPred = pred && !getVectorShape(*pred).isUniform();
+    needsMask |= varyingPred;
+
+    // the predicate of a hoisted load has to be available at this access
+    auto *predInst = dyn_cast_or_null<Instruction>(pred);
+    if (varyingPred && predInst && &srcBlock != inst->getParent() &&
+        !dominatorTree.properlyDominates(predInst->getParent(), inst->getParent()))
+      return false;
+
+    srcPreds.push_back(pred ? pred : ConstantInt::getTrue(inst->getContext()));
+  }
+
+  if (!needsMask) {
+    srcPreds.clear();
+    return true;
   }
+  return config.enableMaskedMove;
+}
+
+void NatBuilder::collectHoistableLoads(LoadInst &load, std::vector<Instruction *> &oCandidates) {
+  BasicBlock &loadBlock = *load.getParent();
+  auto mayWrite = [](const Instruction &inst) { return inst.mayWriteToMemory(); };
+
+  // the load is hoisted over everything that follows it in its own block
+  if (std::any_of(std::next(load.getIterator()), loadBlock.end(), mayWrite))
+    return;
+
+  Function &scaFunc = vecInfo.getScalarFunction();
+  for (BasicBlock &block : scaFunc) {
+    if (&block == &loadBlock || !vecInfo.inRegion(block))
+      continue;
 
-  // we have found a memory group if it has no gaps and the size is bigger than 1
-  return !hasGaps && memGroup.size() > 1 && static_cast<int>(memGroup.size()) == stride;
+    // only blocks that execute whenever the load block does (dominated and post-dominating)
+    if (!dominatorTree.dominates(&loadBlock, &block) || !postDominatorTree.dominates(&block, &loadBlock))
+      continue;
+
+    // no writes on the way from the load block to the block
+    bool writesInBetween = false;
+    for (BasicBlock &otherBlock : scaFunc) {
+      if (&otherBlock == &loadBlock || &otherBlock == &block || !vecInfo.inRegion(otherBlock))
+        continue;
+      if (!dominatorTree.dominates(&loadBlock, &otherBlock) ||
+          !isPotentiallyReachable(&otherBlock, &block, nullptr, &dominatorTree))
+        continue;
+      writesInBetween |= std::any_of(otherBlock.begin(), otherBlock.end(), mayWrite);
+    }
+    if (writesInBetween)
+      continue;
+
+    // loads in front of the first write in the block
+    for (Instruction &inst : block) {
+      if (inst.mayWriteToMemory())
+        break;
+      auto *otherLoad = dyn_cast<LoadInst>(&inst);
+      if (otherLoad && otherLoad->isSimple() && otherLoad->getType() == load.getType())
+        oCandidates.push_back(otherLoad);
+    }
+  }
 }
 
 void NatBuilder::visitMemInstructions() {
@@ -3330,8 +4304,8 @@ void NatBuilder::visitMemInstructions() {
     Type *accessedType = gep->getResultElementType();
     int byteSize = static_cast<int>(layout.getTypeStoreSize(accessedType));
 
-    // keep scalar if uniform or contiguous
-    if (addrShape.isUniform() || addrShape.isContiguous() || addrShape.isStrided(byteSize)) {
+    // keep scalar if uniform or (reverse) contiguous
+    if (addrShape.isUniform() || addrShape.isContiguous() || addrShape.isStrided(byteSize) || addrShape.isStrided(-byteSize)) {
       for (unsigned i = 0; i < gep->getNumIndices(); ++i) {
         Value *idxOp = gep->getOperand(i + 1);
         if (isa<Instruction>(idxOp))
@@ -3366,7 +4340,7 @@ void NatBuilder::visitMemInstructions() {
         Type *accessedType = gep->getResultElementType();
         int byteSize = static_cast<int>(layout.getTypeStoreSize(accessedType));
 
-        if (!(addrShape.isUniform() || addrShape.isContiguous() || addrShape.isStrided(byteSize))) {
+        if (!(addrShape.isUniform() || addrShape.isContiguous() || addrShape.isStrided(byteSize) || addrShape.isStrided(-byteSize))) {
           notScalar = true;
           break;
         }
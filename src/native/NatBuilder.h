@@ -19,11 +19,13 @@
 #include "rv/config.h"
 #include "rv/intrinsics.h"
 #include "rv/analysis/UndeadMaskAnalysis.h"
+#include "rv/analysis/AllTrueMaskAnalysis.h"
 #include "rv/analysis/reductions.h"
 #include "llvm/IR/PassManager.h"
 
 #include <llvm/Analysis/MemoryDependenceAnalysis.h>
 #include <llvm/IR/Dominators.h>
+#include <llvm/Analysis/PostDominators.h>
 #include <llvm/IR/Function.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/Transforms/Utils/ValueMapper.h>
@@ -49,10 +51,12 @@ namespace rv {
     rv::PlatformInfo & platInfo;
     rv::VectorizationInfo &vecInfo;
     const llvm::DominatorTree &dominatorTree;
+    const llvm::PostDominatorTree &postDominatorTree;
     llvm::MemoryDependenceResults & memDepRes;
     llvm::ScalarEvolution &SE;
     rv::ReductionAnalysis & reda;
     rv::UndeadMaskAnalysis undeadMasks;
+    rv::AllTrueMaskAnalysis allTrueMasks;
 
     llvm::DataLayout layout;
 
@@ -75,6 +79,8 @@ namespace rv {
     // generate reduction code (after all other instructions have been vectorized)
     void materializeVaryingReduction(rv::Reduction & red, llvm::PHINode & scaPhi);
     void materializeOrderedReduction(rv::Reduction & red, llvm::PHINode & scaPhi);
+    void materializeScan(rv::Reduction & red, llvm::PHINode & scaPhi);
+    void materializeArgReduction(rv::Reduction & red, llvm::PHINode & scaPhi);
 
     // materialize a recurrence pattern (SCC only consists of phis and selects)
     void materializeRecurrence(rv::Reduction & red, llvm::PHINode & scaPhi);
@@ -92,6 +98,16 @@ namespace rv {
     // scalarize without if-guard
     ValVec scalarize(llvm::BasicBlock & srcBlock, llvm::Instruction & srcInst, bool packResult, std::function<llvm::Value*(llvm::IRBuilder<>&,size_t)> genFunc);
 
+    // loop over the active lanes of the predicate of @srcBlock (ballot, cttz, clear lowest bit) and emit one replica of @srcInst per iteration
+    // varying operands are extracted with the dynamic lane index, if @packResult the results are inserted into a vector accumulator
+    void scalarizeActiveLanes(llvm::BasicBlock & srcBlock, llvm::Instruction & srcInst, bool packResult);
+    bool canScalarizeActiveLanes(llvm::Instruction & inst, bool packResult);
+
+    // lowering of the per-lane replicas of a varying instruction
+    enum class ScalarizeMode { Unguarded, Cascade, ActiveLanes };
+    // pick the cheapest lowering for the replicas of @inst given the expected number of active lanes (@needsGuard: inactive lanes must not execute @inst)
+    ScalarizeMode pickScalarizeMode(llvm::Instruction & inst, bool packResult, bool needsGuard);
+
   public:
     NatBuilder(rv::Config config, rv::PlatformInfo &_platformInfo, rv::VectorizationInfo &_vecInfo,
                rv::ReductionAnalysis & _reda, llvm::FunctionAnalysisManager &FAM);
@@ -132,6 +148,10 @@ namespace rv {
     void vectorizePHIInstruction(llvm::PHINode *const scalPhi);
     void vectorizeMemoryInstruction(llvm::Instruction *const inst);
     void vectorizeCallInstruction(llvm::CallInst *const scalCall);
+    // vectorize @scalCall and a later sin/cos call on the same operand with one sincos call (returns false if there is none)
+    bool vectorizeSinCosPair(llvm::CallInst & scalCall, bool hasCallPredicate);
+    // vectorize a pow call with a constant exponent or a uniform operand without calling pow (returns false if the call site's precision forbids it)
+    bool vectorizePowCall(llvm::CallInst & scalCall, bool hasCallPredicate);
     void vectorizeReductionCall(llvm::CallInst *rvCall, bool isRv_all);
     void vectorizeExtractCall(llvm::CallInst *rvCall);
     void vectorizeInsertCall(llvm::CallInst *rvCall);
@@ -143,8 +163,9 @@ namespace rv {
     void vectorizeAlignCall(llvm::CallInst *rvCall);
     void vectorizeIndexCall(llvm::CallInst & rvCall);
     void vectorizeCompactCall(llvm::CallInst * rvCall);
+    void vectorizeExpandCall(llvm::CallInst * rvCall);
 
-    // create a lookup table for an efficient compaction intrinsic
+    // create a lookup table for an efficient compaction intrinsic (compacts up to 8 lanes, wider vectors are compacted in chunks)
     llvm::Constant* createCompactLookupTable(unsigned vecWidth);
 
     void vectorizeAlloca(llvm::AllocaInst *const allocaInst);
@@ -158,6 +179,10 @@ namespace rv {
     // "vectorize" the instruction by creating scalar replicas and inserting their results in a vector (where appropriate)
     void replicateInstruction(llvm::Instruction *const inst);
 
+    // (non-volatile) atomic updates of the same location are combined in registers and issued once per vector
+    void vectorizeAtomicRMW(llvm::AtomicRMWInst & rmw);
+    llvm::Value *createAggregatedAtomic(llvm::AtomicRMWInst & rmw, RedKind redKind, llvm::Value * ptr, llvm::Value * vecVal, llvm::Value * mask, bool needsGuard);
+
     void addValuesToPHINodes();
 
     void mapOperandsInto(llvm::Instruction *const scalInst, llvm::Instruction *inst, bool vectorizedInst,
@@ -166,6 +191,7 @@ namespace rv {
     llvm::SmallPtrSet<llvm::Instruction *, 16> keepScalar;
     llvm::DenseMap<unsigned, llvm::Function *> cascadeLoadMap;
     llvm::DenseMap<unsigned, llvm::Function *> cascadeStoreMap;
+    llvm::DenseMap<llvm::Type *, llvm::AllocaInst *> scratchSlots; // dummy targets for inactive gather/scatter lanes
     llvm::DenseMap<const llvm::Value *, llvm::Value *> vectorValueMap;
     std::map<const llvm::Value *, LaneValueVector> scalarValueMap;
     std::map<const llvm::BasicBlock *, BasicBlockVector> basicBlockMap;
@@ -186,8 +212,7 @@ namespace rv {
     llvm::Value *requestVectorBitCast(llvm::BitCastInst *const bc);
     llvm::Value *requestScalarBitCast(llvm::BitCastInst *const bc, unsigned laneIdx, bool skipMapping);
 
-    llvm::Value *requestInterleavedGEP(llvm::GetElementPtrInst *const gep, unsigned interleavedIdx);
-    llvm::Value *requestInterleavedAddress(llvm::Value *const addr, unsigned interleavedIdx, llvm::Type *const vecType);
+    llvm::Value *requestInterleavedBase(llvm::Value *const addr, unsigned memberIdx);
 
     llvm::Value *requestCascadeLoad(llvm::Value *vecPtr, unsigned alignment, llvm::Value *mask);
     llvm::Value *requestCascadeStore(llvm::Value *vecVal, llvm::Value *vecPtr, unsigned alignment, llvm::Value *mask);
@@ -199,7 +224,9 @@ namespace rv {
     llvm::Function *getCascadeFunction(unsigned bitWidth, bool store);
 
     llvm::Value& widenScalar(llvm::Value & scaValue, VectorShape vecShape);
-    bool hasUniformPredicate(const llvm::BasicBlock & BB) const;
+    // whether all lanes agree on the predicate of @BB (this includes all-true predicates)
+    bool hasUniformPredicate(const llvm::BasicBlock & BB);
+    bool hasAllTruePredicate(const llvm::BasicBlock & BB);
     llvm::Value *createPTest(llvm::Value *vector, bool isRv_all);
     llvm::Value *maskInactiveLanes(llvm::Value *const value, const llvm::BasicBlock* const block, bool invert);
 
@@ -207,7 +234,13 @@ namespace rv {
 
     bool canVectorize(llvm::Instruction *inst);
     bool shouldVectorize(llvm::Instruction *inst);
-    bool isInterleaved(llvm::Instruction *inst, llvm::Value *accessedPtr, int byteSize, std::vector<llvm::Value *> &srcs);
+    // find the interleaved group of @inst. srcs[k] accesses the k-th element of the window (nullptr for gaps)
+    // srcPreds is empty if the window can be accessed without a mask, otherwise it holds the block predicate of every member (nullptr for gaps)
+    bool isInterleaved(llvm::Instruction *inst, llvm::Value *accessedPtr, int byteSize, std::vector<llvm::Value *> &srcs, std::vector<llvm::Value *> &srcPreds);
+    // whether all @vectorWidth elements of the contiguous access @inst (starting at @accessedPtr) are dereferenceable regardless of the mask
+    bool isDereferenceableVector(llvm::Instruction & inst, llvm::Value & accessedPtr, uint64_t byteSize);
+    // loads in control-equivalent blocks dominated by @load's block that could be hoisted to @load
+    void collectHoistableLoads(llvm::LoadInst &load, std::vector<llvm::Instruction *> &oCandidates);
 
     // request and return all the vector arguments for calling \p vecCall with the vector mappings for the arguments in \p scaCall. this should also include the mask (if any).
     void requestVectorCallArgs(llvm::CallInst & scaCall, llvm::Function & vecCall, int maskPos, std::vector<llvm::Value*> & vectorArgs);
@@ -224,18 +257,32 @@ namespace rv {
     llvm::Value *createUniformMaskedMemory(llvm::Instruction *inst, llvm::Type *accessedType, llvm::Align alignment,
                                            llvm::Value *addr, llvm::Value * scalarMask, llvm::Value *vectorMask, llvm::Value *values);
 
+    llvm::Value *createGatherScatter(llvm::Type *vecType, llvm::Align alignment, llvm::Value *addr, llvm::Value *mask, llvm::Value *values);
+    // whether a masked gather/scatter (or the per-lane cascade) is costlier than an unmasked access with the inactive lanes redirected to a scratch slot
+    // (@laneDensity: expected fraction of active lanes)
+    bool preferSafeAddressAccess(llvm::Type *vecType, llvm::Align alignment, llvm::Value *addr, llvm::Value *mask, bool scatter, double laneDensity);
+    llvm::Value *requestScratchSlot(llvm::Type *elemTy, llvm::Align alignment);
+    // unguarded load/store on every lane of @addr (no gather/scatter intrinsics)
+    llvm::Value *createLaneWiseMemory(llvm::Type *vecType, llvm::Align alignment, llvm::Value *addr, llvm::Value *values);
     llvm::Value *createVaryingMemory(llvm::Type *vecType, llvm::Align alignment, llvm::Value *addr, llvm::Value *mask,
-                                     llvm::Value *values);
-    void createInterleavedMemory(llvm::Type *vecType, llvm::Align alignment, std::vector<llvm::Value *> *addr, std::vector<llvm::Value *> *mask,
-                                     std::vector<llvm::Value *> *values, std::vector<llvm::Value *> *srcs);
+                                     llvm::Value *values, double laneDensity);
+    void createInterleavedMemory(llvm::Type *vecType, llvm::Align alignment, llvm::Value *basePtr, std::vector<llvm::Value *> &masks,
+                                 std::vector<llvm::Value *> &srcs, bool store);
 
     llvm::Value *createContiguousStore(llvm::Value *val, llvm::Value *ptr, llvm::Align alignment, llvm::Value *mask);
     llvm::Value *createContiguousLoad(llvm::Value *ptr, llvm::Align alignment, llvm::Value *mask, llvm::Value *passThru);
+    llvm::Value *createReverseVector(llvm::Value *vec);
 
     void visitMemInstructions();
 
     // match an "*uniPtr += varyinValue" kind of pattern
     RedKind matchMemoryReduction(llvm::Value * scaPtr, llvm::Value * scaValue, llvm::Value *& oPayload, llvm::Instruction *& oScaLoad);
+
+    // match a "*varyingPtr += varyingValue" histogram update in @store (Top if there is none)
+    RedKind matchHistogramUpdate(llvm::StoreInst & store, llvm::Value *& oPayload, llvm::Instruction *& oScaLoad);
+
+    // combine the updates of lanes with the same address and scatter the result from one lane per address
+    llvm::Value *createHistogramStore(RedKind redKind, llvm::Type *vecType, llvm::Align alignment, llvm::Value *vecPtr, llvm::Value *vecOldVal, llvm::Value *vecPayload, llvm::Value *mask);
   };
 }
 
@@ -19,19 +19,18 @@ namespace rv {
   class ShuffleBuilder {
     unsigned vectorWidth;
     std::vector<llvm::Value *> inputVectors;
-    bool cropped;
-
-    void prepareCroppedVector(llvm::IRBuilder<> &builder);
 
   public:
-    ShuffleBuilder(unsigned vectorWidth) : vectorWidth(vectorWidth), inputVectors(), cropped(false) {}
+    ShuffleBuilder(unsigned vectorWidth) : vectorWidth(vectorWidth), inputVectors() {}
     ShuffleBuilder(std::vector<llvm::Value *> &sources, unsigned vectorWidth) : vectorWidth(vectorWidth),
-                                                                               inputVectors(sources), cropped(false) {}
+                                                                               inputVectors(sources) {}
 
     void add(llvm::Value *vector);
     void add(std::vector<llvm::Value *> &sources);
-    llvm::Value *shuffleFromInterleaved(llvm::IRBuilder<> &builder, unsigned stride, unsigned start);
-    llvm::Value *shuffleToInterleaved(llvm::IRBuilder<> &builder, unsigned stride, unsigned start);
+    // concatenate and interleave all input vectors (element i of input k ends up at i * #inputs + k)
+    llvm::Value *interleave(llvm::IRBuilder<> &builder);
+    // de-interleave the elements start, start + stride, .. of the wide vector \p wideVec
+    llvm::Value *extractStrided(llvm::IRBuilder<> &builder, llvm::Value *wideVec, unsigned stride, unsigned start);
     llvm::Value *append(llvm::IRBuilder<> &builder);
     llvm::Value *extractVector(llvm::IRBuilder<> &builder, unsigned index, unsigned offset);
   };
@@ -1,66 +1,259 @@
+//===- src/resolver/TLIResolver.cpp - vector math library calls --*- C++ -*-===//
+//
+// Part of the RV Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Resolves calls to the vector functions that TargetLibraryInfo lists for the
+// target's vector library (-fveclib, eg glibc libmvec, SVML).
+//
+//===----------------------------------------------------------------------===//
+
 #include "rv/resolver/resolver.h"
+#include "rv/resolver/resolvers.h"
 
 #include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/Analysis/TargetTransformInfo.h>
+#include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Function.h>
 
+#include <algorithm>
+#include <cctype>
+
 using namespace llvm;
 
 namespace rv {
 
+// parameters of a vector function variant in the vector function ABI: _ZGV<isa><mask><vlen><params>_<scalar name>
+struct VectorABIVariant {
+  char isa;           // b (SSE), c (AVX), d (AVX2), e (AVX-512) on x86
+  bool masked;        // takes a mask as last argument
+  int vlen;
+  std::string params; // one of 'v' (vector), 'u' (uniform), 'l' (linear) per parameter
+  std::vector<int> linearSteps;
+};
+
+// returns false if @vecName is not a vector function ABI name (or uses unsupported parameter kinds)
+static bool
+ParseVectorABIName(StringRef vecName, VectorABIVariant & variant) {
+  if (!vecName.consume_front("_ZGV") || vecName.size() < 3) return false;
+
+  variant.isa = vecName[0];
+  if (vecName[1] != 'M' && vecName[1] != 'N') return false;
+  variant.masked = vecName[1] == 'M';
+  vecName = vecName.drop_front(2);
+
+  unsigned vlen;
+  if (vecName.consumeInteger(10, vlen) || vlen == 0) return false;
+  variant.vlen = vlen;
+
+  while (!vecName.empty() && vecName[0] != '_') {
+    char kind = vecName[0];
+    vecName = vecName.drop_front(1);
+
+    int step = 0;
+    if (kind == 'l') {
+      bool negative = vecName.consume_front("n");
+      unsigned absStep = 1;
+      if (!vecName.empty() && isdigit(vecName[0]) && vecName.consumeInteger(10, absStep)) return false;
+      step = negative ? -(int) absStep : (int) absStep;
+    } else if (kind != 'v' && kind != 'u') {
+      return false; // variable strides, references
+    }
+
+    // alignment annotation
+    unsigned align;
+    if (vecName.consume_front("a") && vecName.consumeInteger(10, align)) return false;
+
+    variant.params.push_back(kind);
+    variant.linearSteps.push_back(step);
+  }
+  return vecName.startswith("_");
+}
+
 class TLIFuncResolver : public FunctionResolver {
-  TargetLibraryInfo & TLI;
-  llvm::StringRef funcName;
+  std::string vecFuncName;
   llvm::FunctionType & scaFuncTy;
+  VectorShapeVec argShapes;
   int vectorWidth;
+  bool preferred;
+
+  VectorABIVariant variant;
+  bool isABIName;
+
+  Type * getVectorTy(Type * scaTy) const { return VectorType::get(scaTy, vectorWidth); }
+
+  // the characteristic data type determines the mask type of SSE/AVX variants
+  Type * getCharacteristicTy() const {
+    if (!scaFuncTy.getReturnType()->isVoidTy()) return scaFuncTy.getReturnType();
+    for (int i = 0; i < (int) variant.params.size(); ++i) {
+      if (variant.params[i] == 'v') return scaFuncTy.getParamType(i);
+    }
+    return Type::getInt32Ty(scaFuncTy.getContext());
+  }
+
+  // mask operand type of the library function
+  Type * getABIMaskTy() const {
+    auto & context = scaFuncTy.getContext();
+    switch (variant.isa) {
+      case 'e': return Type::getIntNTy(context, std::max(8, vectorWidth)); // k-register
+      case 'b': case 'c': case 'd': return getVectorTy(getCharacteristicTy());
+      default: return getVectorTy(Type::getInt1Ty(context));
+    }
+  }
+
+  // declare the library function with the type that the ABI name implies (all-vector parameters otherwise)
+  Function & requestDeclaration() {
+    if (auto * existingFunc = targetModule.getFunction(vecFuncName)) return *existingFunc;
+
+    SmallVector<Type*, 4> vecParamTys;
+    for (int i = 0; i < (int) scaFuncTy.getNumParams(); ++i) {
+      auto * scaParamTy = scaFuncTy.getParamType(i);
+      bool isVector = !isABIName || variant.params[i] == 'v';
+      vecParamTys.push_back(isVector ? getVectorTy(scaParamTy) : scaParamTy);
+    }
+    if (isABIName && variant.masked) vecParamTys.push_back(getABIMaskTy());
+
+    auto * scaRetTy = scaFuncTy.getReturnType();
+    auto * vecRetTy = scaRetTy->isVoidTy() ? scaRetTy : getVectorTy(scaRetTy);
+    auto * vecFuncTy = FunctionType::get(vecRetTy, vecParamTys, false);
+
+    auto * vecFunc = Function::Create(vecFuncTy, GlobalValue::ExternalLinkage, vecFuncName, &targetModule);
+    vecFunc->setDoesNotThrow();
+    vecFunc->setDoesNotAccessMemory(); // vector math libraries do not set errno
+    return *vecFunc;
+  }
+
+  // masked variants are called through a wrapper that converts RV's <W x i1> predicate into the ABI mask
+  Function & requestMaskedWrapper(Function & libFunc) {
+    std::string wrapperName = vecFuncName + ".rvmask";
+    if (auto * existingFunc = targetModule.getFunction(wrapperName)) return *existingFunc;
+
+    auto & context = targetModule.getContext();
+    auto * libFuncTy = libFunc.getFunctionType();
+    SmallVector<Type*, 4> wrapperParamTys(libFuncTy->param_begin(), libFuncTy->param_end());
+    wrapperParamTys.back() = getVectorTy(Type::getInt1Ty(context));
+    auto * wrapperTy = FunctionType::get(libFuncTy->getReturnType(), wrapperParamTys, false);
+
+    auto * wrapper = Function::Create(wrapperTy, GlobalValue::InternalLinkage, wrapperName, &targetModule);
+    wrapper->addFnAttr(Attribute::AlwaysInline);
+    wrapper->setDoesNotThrow();
+    wrapper->setDoesNotAccessMemory();
+
+    IRBuilder<> builder(BasicBlock::Create(context, "entry", wrapper));
+    SmallVector<Value*, 4> libArgs;
+    for (auto & arg : wrapper->args()) libArgs.push_back(&arg);
+
+    Value * mask = libArgs.back();
+    auto * abiMaskTy = getABIMaskTy();
+    if (abiMaskTy->isIntegerTy()) {
+      mask = builder.CreateZExtOrTrunc(builder.CreateBitCast(mask, builder.getIntNTy(vectorWidth)), abiMaskTy, "abimask");
+    } else if (abiMaskTy != mask->getType()) {
+      auto * laneTy = cast<VectorType>(abiMaskTy)->getElementType();
+      auto * intLaneTy = builder.getIntNTy(laneTy->getPrimitiveSizeInBits());
+      mask = builder.CreateBitCast(builder.CreateSExt(mask, getVectorTy(intLaneTy)), abiMaskTy, "abimask");
+    }
+    libArgs.back() = mask;
+
+    auto * call = builder.CreateCall(&libFunc, libArgs);
+    if (wrapperTy->getReturnType()->isVoidTy()) builder.CreateRetVoid();
+    else builder.CreateRet(call);
+    return *wrapper;
+  }
 
 public:
-  TLIFuncResolver(Module & _destModule, TargetLibraryInfo & _TLI, llvm::StringRef _funcName, llvm::FunctionType & _scaFuncTy, int _vectorWidth)
+  TLIFuncResolver(Module & _destModule, StringRef _vecFuncName, llvm::FunctionType & _scaFuncTy, const VectorShapeVec & _argShapes, int _vectorWidth, bool _preferred)
   : FunctionResolver(_destModule)
-  , TLI(_TLI)
-  , funcName(_funcName)
+  , vecFuncName(_vecFuncName.str())
   , scaFuncTy(_scaFuncTy)
+  , argShapes(_argShapes)
   , vectorWidth(_vectorWidth)
+  , preferred(_preferred)
+  , variant()
+  , isABIName(ParseVectorABIName(_vecFuncName, variant))
   {}
 
+  // whether the library function accepts the argument shapes of the call site
+  bool isApplicable() const {
+    if (!isABIName) return true; // all arguments are passed as vectors
+
+    if (variant.vlen != vectorWidth) return false;
+    if ((int) variant.params.size() != (int) scaFuncTy.getNumParams()) return false;
+    for (int i = 0; i < (int) variant.params.size(); ++i) {
+      switch (variant.params[i]) {
+        case 'u': if (!argShapes[i].isUniform()) return false; break;
+        case 'l': if (!argShapes[i].isStrided(variant.linearSteps[i])) return false; break;
+        default: break;
+      }
+    }
+    return true;
+  }
+
   VectorShape
-  requestResultShape() { return VectorShape::varying(); }
+  requestResultShape() { return ComputeShape(argShapes); }
 
   CallPredicateMode getCallSitePredicateMode() {
-    // not generally safe in a predicated context
-    return CallPredicateMode::Unpredicated;
+    // vector math library functions do not have side effects
+    return getMaskPos() >= 0 ? CallPredicateMode::PredicateArg : CallPredicateMode::SafeWithoutPredicate;
   }
 
   // mask position (if any)
   int getMaskPos() {
-    return -1;  // unpredicated
+    return (isABIName && variant.masked) ? (int) scaFuncTy.getNumParams() : -1;
   }
 
+  // an opaque library call is ranked behind inlined SLEEF code unless the vector library is preferred
+  FunctionCost requestCostEstimate() { return FunctionCost{preferred ? 1u : 3u}; }
+
   Function& requestVectorized() {
-    // TODO actually emit a SIMD declaration for this function
-    StringRef tliFnName = TLI.getVectorizedFunction(funcName, vectorWidth);
-    return *targetModule.getFunction(tliFnName);
+    Function & libFunc = requestDeclaration();
+    if (getMaskPos() < 0) return libFunc;
+    return requestMaskedWrapper(libFunc);
   }
 };
 
+// vector math libraries (libmvec, SVML) only guarantee 4 ULP (in tenths of ULP)
+static const int VectorLibraryULPError = 40;
+
 class TLIResolverService : public ResolverService {
   TargetLibraryInfo & TLI;
+  Config config;
 
 public:
-  TLIResolverService(TargetLibraryInfo & _TLI)
+  TLIResolverService(TargetLibraryInfo & _TLI, const Config & _config)
   : TLI(_TLI)
+  , config(_config)
   {}
 
+  void print(llvm::raw_ostream & out) const override {
+    out << "TLIResolver (prefer vector library: " << config.preferVectorLibrary << ")";
+  }
+
+  FunctionCost getCostLowerBound() const override { return FunctionCost{config.preferVectorLibrary ? 1u : 3u}; }
+
   std::unique_ptr<FunctionResolver>
-  resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, llvm::Module & destModule) {
+  resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, int maxULPError, llvm::Module & destModule) override {
+    // the library is not precise enough for this call site (unless it is afn)
+    const int ulpBound = (maxULPError == DefaultULPErrorBound) ? config.maxULPErrorBound : maxULPError;
+    if (ulpBound < VectorLibraryULPError) return nullptr;
+
     StringRef tliFnName = TLI.getVectorizedFunction(funcName, vectorWidth);
-    if (!tliFnName.empty()) {
-      return std::make_unique<TLIFuncResolver>(destModule, TLI, funcName, scaFuncTy, vectorWidth);
-    }
-    return nullptr;
+    if (tliFnName.empty()) return nullptr;
+
+    auto funcResolver = std::make_unique<TLIFuncResolver>(destModule, tliFnName, scaFuncTy, argShapes, vectorWidth, config.preferVectorLibrary);
+    if (!funcResolver->isApplicable()) return nullptr;
+    return funcResolver;
   }
 };
 
+void
+addTLIResolver(const Config & config, PlatformInfo & platInfo) {
+  auto * TLI = platInfo.getTLI();
+  if (!TLI) return;
+  platInfo.addResolverService(std::make_unique<TLIResolverService>(*TLI, config), false);
+}
 
 } // namespace rv
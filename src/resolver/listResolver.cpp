@@ -172,7 +172,7 @@ public:
 
 // result shape of function @funcName in target module @module.
 std::unique_ptr<FunctionResolver>
-ListResolver::resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, llvm::Module & destModule) {
+ListResolver::resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, int maxULPError, llvm::Module & destModule) {
   IF_DEBUG_LRES { errs() << "ListResolverService: " << funcName << " for width " << vectorWidth << "\n"; }
 
   // scalar function not available
@@ -58,7 +58,10 @@ class RecursiveResolverService : public ResolverService {
   VectorizerInterface vectorizer;
 
 public:
-  std::unique_ptr<FunctionResolver> resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, llvm::Module & destModule) override;
+  std::unique_ptr<FunctionResolver> resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, int maxULPError, llvm::Module & destModule) override;
+
+  // see RecursiveResolver::requestCostEstimate (vectorizes the callee in resolve())
+  FunctionCost getCostLowerBound() const override { return FunctionCost{4}; }
 
   RecursiveResolverService(PlatformInfo & platInfo, Config config)
   : vectorizer(platInfo, config)
@@ -99,6 +102,9 @@ public:
   // mask position (if any)
   int getMaskPos() { return recMapping.maskPos; }
 
+  // vectorized function bodies are ranked behind library implementations
+  FunctionCost requestCostEstimate() { return FunctionCost{4}; }
+
   bool isValid() const { return hasValidVectorFunc; }
 
   RecursiveResolver(VectorizerInterface & vectorizer, Function & scaFunc, VectorShapeVec argShapes, int vectorWidth, bool hasCallSitePredicate)
@@ -256,7 +262,7 @@ public:
 
 
 std::unique_ptr<FunctionResolver>
-RecursiveResolverService::resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, llvm::Module & destModule) {
+RecursiveResolverService::resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, int maxULPError, llvm::Module & destModule) {
 // is this function defined?
   auto * scaFunc = destModule.getFunction(funcName);
   if (!scaFunc) return nullptr;
@@ -9,8 +9,13 @@
 #include "rv/resolver/resolver.h"
 #include "rv/shape/vectorShape.h"
 
+#include <llvm/IR/Instructions.h>
+#include <llvm/IR/Operator.h>
 #include <llvm/Support/raw_ostream.h>
 
+#include <algorithm>
+#include <limits>
+
 namespace rv {
 
 ResolverService::~ResolverService()
@@ -39,5 +44,17 @@ FunctionResolver::ComputeShape(const VectorShapeVec & argShapes) {
   return VectorShape::uni();
 }
 
+int
+GetCallSiteULPBound(const llvm::CallInst & call, int defaultBound) {
+  if (!llvm::isa<llvm::FPMathOperator>(call)) return defaultBound;
+
+  // afn (or fast): any approximation of the function will do
+  if (call.hasApproxFunc()) return std::numeric_limits<int>::max();
+
+  // !fpmath: the admissible error in ULP
+  float fpAccuracy = llvm::cast<llvm::FPMathOperator>(call).getFPAccuracy();
+  int fpBound = (int) (fpAccuracy * 10.0f);
+  return std::max(defaultBound, fpBound);
+}
 
 } // namespace rv
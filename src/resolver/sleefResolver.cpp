@@ -10,7 +10,9 @@
 #include <llvm/Transforms/Utils/Cloning.h>
 #include <llvm/IR/InstIterator.h>
 #include <llvm/IR/Constants.h>
+#include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/ValueHandle.h>
 #include <llvm/IR/Dominators.h>
 #include <llvm/Analysis/PostDominators.h>
 #include <llvm/Analysis/LoopInfo.h>
@@ -29,9 +31,14 @@
 #include "rv/transform/loopExitCanonicalizer.h"
 #include "report.h"
 
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Object/IRSymtab.h>
 #include <llvm/IR/Verifier.h>
 #include <vector>
 #include <sstream>
+#include <algorithm>
+#include <map>
+#include <mutex>
 
 #if 1
 #define IF_DEBUG_SLEEF IF_DEBUG
@@ -243,8 +250,128 @@ static const unsigned char** extraModuleBuffers[] = {
 
 
 
-static Module *sleefModules[SLEEF_Enum_Entries * 2];
-static Module *extraModules[SLEEF_Enum_Entries * 2];
+// extra modules are numbered after the SP and DP SLEEF modules
+inline int extraModuleIndex(SleefISA isa) {
+  return 2 * (int) SLEEF_Enum_Entries + int(isa);
+}
+
+static const int SleefLibraryEntries = 3 * (int) SLEEF_Enum_Entries;
+
+// embedded bitcode of library @libIndex (empty if not part of this build)
+static StringRef
+GetLibraryBuffer(int libIndex) {
+  if (libIndex < 2 * (int) SLEEF_Enum_Entries) {
+    return StringRef(reinterpret_cast<const char*>(sleefModuleBuffers[libIndex]), sleefModuleBufferLens[libIndex]);
+  }
+  int extraIdx = libIndex - 2 * (int) SLEEF_Enum_Entries;
+  if (!extraModuleBuffers[extraIdx]) return StringRef();
+  return StringRef(reinterpret_cast<const char*>(extraModuleBuffers[extraIdx]), extraModuleBufferLens[extraIdx]);
+}
+
+struct SleefLibraryCache;
+static SleefLibraryCache & GetLibraryCache();
+
+using LibraryKey = std::pair<const LLVMContext*, int>;
+
+// Tracks a sentinel global in a cached library module.
+// The module is owned by its LLVMContext: when the context (and with it the module) is destroyed, the handle drops the cache entry.
+struct LibraryModuleHandle final : public CallbackVH {
+  LibraryKey key;
+  LibraryModuleHandle(Value * sentinel, LibraryKey key) : CallbackVH(sentinel), key(key) {}
+  void deleted() override;
+};
+
+struct CachedLibraryModule {
+  Module * mod;
+  std::unique_ptr<LibraryModuleHandle> handle;
+};
+
+// Process-wide SLEEF library state.
+// The symbol index (names of all functions with a body in each library) is context-independent and read once from the bitcode symbol table.
+// Library modules are loaded lazily, once per (LLVMContext, library), and only materialize the functions that are cloned out of them.
+// The cached modules are owned by their context and leave the cache when it is destroyed.
+struct SleefLibraryCache {
+  std::mutex mutex;
+
+  bool indexed[SleefLibraryEntries] = {};
+  bool hasIndex[SleefLibraryEntries] = {};
+  std::vector<std::string> symbolIndex[SleefLibraryEntries];
+
+  std::map<LibraryKey, CachedLibraryModule> modules;
+};
+
+static SleefLibraryCache &
+GetLibraryCache() {
+  static SleefLibraryCache libCache;
+  return libCache;
+}
+
+void
+LibraryModuleHandle::deleted() {
+  auto & libCache = GetLibraryCache();
+  std::lock_guard<std::mutex> guard(libCache.mutex);
+  libCache.modules.erase(key); // destroys this handle
+}
+
+// read the defined function names of @buffer from its bitcode symbol table (without parsing the module)
+static bool
+ReadSymbolIndex(StringRef buffer, std::vector<std::string> & names) {
+  if (buffer.empty()) return true;
+
+  auto bfcOrErr = getBitcodeFileContents(MemoryBufferRef(buffer, ""));
+  if (!bfcOrErr) {
+    consumeError(bfcOrErr.takeError());
+    return false;
+  }
+  auto fcOrErr = irsymtab::readBitcode(*bfcOrErr);
+  if (!fcOrErr) {
+    consumeError(fcOrErr.takeError());
+    return false;
+  }
+
+  irsymtab::Reader symReader({fcOrErr->Symtab.data(), fcOrErr->Symtab.size()},
+                             {fcOrErr->Strtab.data(), fcOrErr->Strtab.size()});
+  for (auto sym : symReader.symbols()) {
+    if (sym.isUndefined() || sym.getIRName().empty()) continue;
+    names.push_back(sym.getIRName().str());
+  }
+  std::sort(names.begin(), names.end());
+  return true;
+}
+
+// names of all functions with a body in library @libIndex.
+// Returns nullptr if the library has no usable symbol table (the caller has to inspect the module instead).
+static const std::vector<std::string> *
+RequestSymbolIndex(int libIndex) {
+  auto & libCache = GetLibraryCache();
+  std::lock_guard<std::mutex> guard(libCache.mutex);
+  if (!libCache.indexed[libIndex]) {
+    libCache.indexed[libIndex] = true;
+    libCache.hasIndex[libIndex] = ReadSymbolIndex(GetLibraryBuffer(libIndex), libCache.symbolIndex[libIndex]);
+  }
+  return libCache.hasIndex[libIndex] ? &libCache.symbolIndex[libIndex] : nullptr;
+}
+
+// lazily loaded module of library @libIndex in @context
+static Module &
+RequestLibraryModule(int libIndex, LLVMContext & context) {
+  auto & libCache = GetLibraryCache();
+  std::lock_guard<std::mutex> guard(libCache.mutex);
+  LibraryKey key(&context, libIndex);
+  auto it = libCache.modules.find(key);
+  if (it != libCache.modules.end()) return *it->second.mod;
+
+  StringRef buffer = GetLibraryBuffer(libIndex);
+  Module * mod = createLazyModuleFromBuffer(buffer.data(), buffer.size(), context);
+  if (!mod) {
+    Report() << "sleef: could not load library " << libIndex << "\n";
+    abort();
+  }
+  auto * sentinel = new GlobalVariable(*mod, Type::getInt8Ty(context), true, GlobalValue::PrivateLinkage,
+                                       ConstantInt::get(Type::getInt8Ty(context), 0), "rv_sleef_cache_sentinel");
+  libCache.modules[key] = CachedLibraryModule{mod, std::make_unique<LibraryModuleHandle>(sentinel, key)};
+  return *mod;
+}
 
 static
 void
@@ -266,7 +393,6 @@ InitSleefMappings(PlainVecDescVector & archMappings, int floatWidth, int doubleW
           {"frfrexpf", "xfrfrexpf",  floatWidth},
           {"expfrexpf", "xexpfrexpf", floatWidth},
           {"fmodf", "xfmodf", floatWidth},
-          {"modff", "xmodff", floatWidth},
 
           {"ilogb", "xilogb", doubleWidth},
           {"fma", "xfma", doubleWidth},
@@ -284,7 +410,6 @@ InitSleefMappings(PlainVecDescVector & archMappings, int floatWidth, int doubleW
           {"frfrexp", "xfrfrexp", doubleWidth},
           {"expfrexp", "xexpfrexp", doubleWidth},
           {"fmod", "xfmod", doubleWidth},
-          {"modf", "xmodf", floatWidth},
 
           {"llvm.floor.f32", "xfloorf", floatWidth},
           {"llvm.fabs.f32", "xfabsf", floatWidth},
@@ -324,6 +449,7 @@ InitSleefMappings(PlainVecDescVector & archMappings, int floatWidth, int doubleW
             {"exp10f", "xexp10f", floatWidth},
             {"expm1f", "xexpm1f", floatWidth},
             {"log10f", "xlog10f", floatWidth},
+            {"log2f", "xlog2f", floatWidth},
             {"log1pf", "xlog1pf", floatWidth},
             {"sqrtf", "xsqrtf", floatWidth},
             {"hypotf", "xhypotf",  floatWidth},
@@ -353,6 +479,7 @@ InitSleefMappings(PlainVecDescVector & archMappings, int floatWidth, int doubleW
             {"exp10", "xexp10", doubleWidth},
             {"expm1", "xexpm1", doubleWidth},
             {"log10", "xlog10", doubleWidth},
+            {"log2", "xlog2", doubleWidth},
             {"log1p", "xlog1p", doubleWidth},
             {"sqrt", "xsqrt", doubleWidth},
             {"hypot", "xhypot", doubleWidth},
@@ -369,6 +496,7 @@ InitSleefMappings(PlainVecDescVector & archMappings, int floatWidth, int doubleW
             {"llvm.sqrt.f32", "xsqrtf", floatWidth},
             {"llvm.exp2.f32", "xexp2f", floatWidth},
             {"llvm.log10.f32", "xlog10f", floatWidth},
+            {"llvm.log2.f32", "xlog2f", floatWidth},
             {"llvm.sin.f64", "xsin", doubleWidth},
             {"llvm.cos.f64", "xcos", doubleWidth},
             {"llvm.log.f64", "xlog", doubleWidth},
@@ -376,12 +504,15 @@ InitSleefMappings(PlainVecDescVector & archMappings, int floatWidth, int doubleW
             {"llvm.pow.f64", "xpow", doubleWidth},
             {"llvm.sqrt.f64", "xsqrt", doubleWidth},
             {"llvm.exp2.f64", "xexp2", doubleWidth},
-            {"llvm.log10.f64", "xlog10", doubleWidth}
+            {"llvm.log10.f64", "xlog10", doubleWidth},
+            {"llvm.log2.f64", "xlog2", doubleWidth}
         };
         archMappings.insert(archMappings.end(), VecFuncs.begin(), VecFuncs.end());
 }
 
 
+struct TwoResultDesc;
+
 class SleefResolverService : public ResolverService {
   PlatformInfo & platInfo;
 
@@ -406,6 +537,9 @@ class SleefResolverService : public ResolverService {
 
   Config config;
 
+  // sincos, modf and frexp (and fused sin/cos pairs)
+  std::unique_ptr<FunctionResolver> resolveTwoResultFunc(const TwoResultDesc & desc, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, int ulpBound, llvm::Module & destModule);
+
 
 public:
   void
@@ -474,7 +608,7 @@ public:
     for (auto * archList : archLists) delete archList;
   }
 
-  std::unique_ptr<FunctionResolver> resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, llvm::Module & destModule) override;
+  std::unique_ptr<FunctionResolver> resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, int maxULPError, llvm::Module & destModule) override;
 };
 
 
@@ -508,6 +642,9 @@ class SleefLookupResolver : public FunctionResolver {
     return -1; // FIXME vector math is unpredicated
   }
 
+  // linking in SLEEF code is ranked behind existing vector functions (eg intrinsics)
+  FunctionCost requestCostEstimate() { return FunctionCost{vecFunc.isDeclaration() ? 1u : 2u}; }
+
   llvm::Function&
   requestVectorized() {
     auto * existingFunc = targetModule.getFunction(destFuncName);
@@ -564,6 +701,9 @@ struct SleefVLAResolver : public FunctionResolver {
     return -1; // FIXME vector math is unpredicated
   }
 
+  // vectorizing the scalar implementation on the fly is ranked behind pre-vectorized code
+  FunctionCost requestCostEstimate() { return FunctionCost{3}; }
+
   // materialized the vectorized function in the module @insertInto and returns a reference to it
   llvm::Function& requestVectorized() {
     if (vecFunc) return *vecFunc;
@@ -659,6 +799,211 @@ struct SleefVLAResolver : public FunctionResolver {
   }
 };
 
+// SLEEF functions that compute two results at once.
+// The scalar function either returns both results in a struct (fused sin/cos calls) or the first result is returned (or stored) and the other is stored through out-parameters (sincos, modf, frexp).
+struct TwoResultDesc {
+  const char * scalarFnName;
+  const char * firstImplName;  // computes both results (if secondImplName is nullptr)
+  const char * secondImplName; // computes the second result
+  bool intSecond;              // the second result is an i32 (frexp exponent)
+};
+
+static const TwoResultDesc TwoResultFuncs[] = {
+  {"sincosf", "xsincosf", nullptr, false},
+  {"sincos", "xsincos", nullptr, false},
+  {"modff", "xmodff", nullptr, false},
+  {"modf", "xmodf", nullptr, false},
+  {"frexpf", "xfrfrexpf", "xexpfrexpf", true},
+  {"frexp", "xfrfrexp", "xexpfrexp", true},
+};
+
+static const TwoResultDesc *
+GetTwoResultDesc(StringRef funcName) {
+  for (const auto & desc : TwoResultFuncs) {
+    if (funcName == desc.scalarFnName) return &desc;
+  }
+  return nullptr;
+}
+
+// wraps the pre-vectorized SLEEF implementation(s) of a function with two results.
+// Contiguous out-parameters are passed as scalar pointers, all others as vectors of pointers.
+class SleefTwoResultResolver : public FunctionResolver {
+  const TwoResultDesc & desc;
+  Function & firstImpl;
+  Function * secondImpl;
+  std::string archSuffix;
+  FunctionType & scaFuncTy;
+  VectorShapeVec argShapes;
+  int vectorWidth;
+  std::string vecFuncName;
+
+  // the scalar function returns both results as a struct (no memory effects)
+  bool returnsPair() const { return scaFuncTy.getReturnType()->isStructTy(); }
+
+  // position of the mask argument (out-parameter stores are predicated)
+  int maskPos() const { return returnsPair() ? -1 : (int) argShapes.size(); }
+
+  bool passScalarPointer(int argIdx) const {
+    auto * elemTy = cast<PointerType>(scaFuncTy.getParamType(argIdx))->getElementType();
+    int elemBytes = targetModule.getDataLayout().getTypeStoreSize(elemTy);
+    return argShapes[argIdx].isStrided(elemBytes);
+  }
+
+  Function & linkImpl(Function & implFunc) {
+    Function & clonedImpl = cloneFunctionIntoModule(implFunc, targetModule, implFunc.getName().str() + "_" + archSuffix);
+    clonedImpl.setDoesNotRecurse(); // SLEEF math does not recurse
+    return clonedImpl;
+  }
+
+  // store the vector @vecVal to the out-parameter @ptrArg (shape @ptrShape) for all lanes in @mask
+  void storeResult(IRBuilder<> & builder, Value & vecVal, Value & ptrArg, const VectorShape & ptrShape, Value & mask) {
+    auto & DL = targetModule.getDataLayout();
+    auto * elemTy = cast<VectorType>(vecVal.getType())->getElementType();
+    llvm::Align elemAlign(DL.getABITypeAlignment(elemTy));
+
+    // varying pointers
+    if (ptrArg.getType()->isVectorTy()) {
+      builder.CreateMaskedScatter(&vecVal, &ptrArg, elemAlign, &mask);
+      return;
+    }
+
+    // contiguous out-parameter (uniform out-parameters are rejected in resolveTwoResultFunc)
+    assert(!ptrShape.isUniform());
+    auto * vecPtrTy = PointerType::get(vecVal.getType(), ptrArg.getType()->getPointerAddressSpace());
+    builder.CreateMaskedStore(&vecVal, builder.CreatePointerCast(&ptrArg, vecPtrTy), elemAlign, &mask);
+  }
+
+  // the i32 lanes of the integer result @intVec of an implementation.
+  // Either one (wider) integer per lane or i32 lanes packed into the low half of the register (eg <2 x i64> for 2 x i32 at double precision).
+  Value & convertIntResult(IRBuilder<> & builder, Value & intVec) {
+    auto & context = targetModule.getContext();
+    auto * i32Ty = Type::getInt32Ty(context);
+    auto * intVecTy = cast<FixedVectorType>(intVec.getType());
+    unsigned numElems = intVecTy->getNumElements();
+    unsigned elemBits = intVecTy->getScalarSizeInBits();
+
+    if ((int) numElems == vectorWidth) {
+      return *builder.CreateTrunc(&intVec, VectorType::get(i32Ty, vectorWidth), "second_lanes");
+    }
+
+    unsigned numInt32 = numElems * elemBits / 32;
+    assert(numInt32 >= (unsigned) vectorWidth && "integer result does not hold a lane per value");
+    auto * packed = builder.CreateBitCast(&intVec, VectorType::get(i32Ty, numInt32), "second_i32");
+    if ((int) numInt32 == vectorWidth) return *packed;
+
+    SmallVector<Constant*, 16> lowLanes;
+    for (int i = 0; i < vectorWidth; ++i) lowLanes.push_back(ConstantInt::get(i32Ty, i));
+    return *builder.CreateShuffleVector(packed, UndefValue::get(packed->getType()), ConstantVector::get(lowLanes), "second_lanes");
+  }
+
+public:
+  SleefTwoResultResolver(PlatformInfo & platInfo, Module & destModule, const TwoResultDesc & _desc, Function & _firstImpl, Function * _secondImpl, std::string _archSuffix, FunctionType & _scaFuncTy, const VectorShapeVec & _argShapes, int _vectorWidth)
+  : FunctionResolver(destModule)
+  , desc(_desc)
+  , firstImpl(_firstImpl)
+  , secondImpl(_secondImpl)
+  , archSuffix(_archSuffix)
+  , scaFuncTy(_scaFuncTy)
+  , argShapes(_argShapes)
+  , vectorWidth(_vectorWidth)
+  , vecFuncName(platInfo.createMangledVectorName(desc.scalarFnName, argShapes, vectorWidth, maskPos()) + "_" + archSuffix)
+  {}
+
+  CallPredicateMode getCallSitePredicateMode() {
+    return returnsPair() ? CallPredicateMode::SafeWithoutPredicate : CallPredicateMode::PredicateArg;
+  }
+
+  int getMaskPos() { return maskPos(); }
+
+  FunctionCost requestCostEstimate() { return FunctionCost{2}; }
+
+  // the results only depend on the value operand
+  VectorShape requestResultShape() { return ComputeShape({argShapes[0]}); }
+
+  llvm::Function& requestVectorized() {
+    auto * existingFunc = targetModule.getFunction(vecFuncName);
+    if (existingFunc) return *existingFunc;
+
+    Function & firstFunc = linkImpl(firstImpl);
+    Function * secondFunc = secondImpl ? &linkImpl(*secondImpl) : nullptr;
+
+    // vector signature
+    auto & context = targetModule.getContext();
+    auto * vecValTy = VectorType::get(scaFuncTy.getParamType(0), vectorWidth);
+    SmallVector<Type*, 4> vecParamTys;
+    vecParamTys.push_back(vecValTy);
+    for (int i = 1; i < (int) scaFuncTy.getNumParams(); ++i) {
+      auto * ptrTy = scaFuncTy.getParamType(i);
+      vecParamTys.push_back(passScalarPointer(i) ? ptrTy : VectorType::get(ptrTy, vectorWidth));
+    }
+    if (maskPos() >= 0) vecParamTys.push_back(VectorType::get(Type::getInt1Ty(context), vectorWidth));
+
+    Type * vecRetTy = Type::getVoidTy(context);
+    if (returnsPair()) vecRetTy = StructType::get(vecValTy, vecValTy);
+    else if (!scaFuncTy.getReturnType()->isVoidTy()) vecRetTy = vecValTy;
+
+    auto * vecFuncTy = FunctionType::get(vecRetTy, vecParamTys, false);
+    auto * vecFunc = Function::Create(vecFuncTy, GlobalValue::InternalLinkage, vecFuncName, &targetModule);
+    vecFunc->setDoesNotRecurse();
+    vecFunc->addFnAttr(Attribute::AlwaysInline);
+    if (returnsPair()) vecFunc->setDoesNotAccessMemory();
+
+    SmallVector<Value*, 4> vecArgs;
+    for (auto & arg : vecFunc->args()) vecArgs.push_back(&arg);
+
+    auto * entry = BasicBlock::Create(context, "entry", vecFunc);
+    IRBuilder<> builder(entry);
+    Value * vecVal = vecArgs[0];
+
+    // compute both results
+    Value * first = nullptr;
+    Value * second = nullptr;
+    if (secondFunc) {
+      first = builder.CreateCall(&firstFunc, {vecVal}, "first");
+      second = builder.CreateCall(secondFunc, {vecVal}, "second");
+    } else if (firstFunc.hasStructRetAttr()) {
+      // pair returned in memory
+      auto * pairTy = cast<PointerType>(firstFunc.getArg(0)->getType())->getElementType();
+      auto * pairPtr = builder.CreateAlloca(pairTy, nullptr, "pair");
+      builder.CreateCall(&firstFunc, {pairPtr, vecVal});
+      first = builder.CreateLoad(cast<StructType>(pairTy)->getElementType(0), builder.CreateStructGEP(pairTy, pairPtr, 0), "first");
+      second = builder.CreateLoad(cast<StructType>(pairTy)->getElementType(1), builder.CreateStructGEP(pairTy, pairPtr, 1), "second");
+    } else {
+      auto * pair = builder.CreateCall(&firstFunc, {vecVal}, "pair");
+      first = builder.CreateExtractValue(pair, 0, "first");
+      second = builder.CreateExtractValue(pair, 1, "second");
+    }
+
+    // SLEEF returns integer vectors in whatever type the ISA uses (eg <4 x i64> for 8 x i32)
+    auto * secondTy = desc.intSecond ? VectorType::get(Type::getInt32Ty(context), vectorWidth) : vecValTy;
+    if (desc.intSecond && (second->getType() != secondTy)) {
+      second = &convertIntResult(builder, *second);
+    } else if (second->getType() != secondTy) {
+      second = builder.CreateBitCast(second, secondTy);
+    }
+
+    if (returnsPair()) {
+      Value * pair = UndefValue::get(vecRetTy);
+      pair = builder.CreateInsertValue(pair, first, 0);
+      pair = builder.CreateInsertValue(pair, second, 1);
+      builder.CreateRet(pair);
+      return *vecFunc;
+    }
+
+    // store through the out-parameters
+    Value & mask = *vecArgs[maskPos()];
+    if (vecRetTy->isVoidTy()) {
+      storeResult(builder, *first, *vecArgs[1], argShapes[1], mask);
+      storeResult(builder, *second, *vecArgs[2], argShapes[2], mask);
+      builder.CreateRetVoid();
+    } else {
+      storeResult(builder, *second, *vecArgs[1], argShapes[1], mask);
+      builder.CreateRet(first);
+    }
+    return *vecFunc;
+  }
+};
+
 // used for shape-based call mappings
 using VecMappingShortVec = llvm::SmallVector<VectorMapping, 4>;
 using VectorFuncMap = std::map<const llvm::Function *, VecMappingShortVec*>;
@@ -666,9 +1011,9 @@ using VectorFuncMap = std::map<const llvm::Function *, VecMappingShortVec*>;
 // parse ULP error bound from mangled SLEEF name
 static unsigned
 ReadULPBound(StringRef sleefName) {
-  auto itStart = sleefName.find_last_of("_u");
+  auto itStart = sleefName.rfind("_u");
   if (itStart == StringRef::npos) return 0; // unspecified -> perfect rounding
-  StringRef ulpPart = sleefName.substr(itStart + 1);
+  StringRef ulpPart = sleefName.substr(itStart + 2);
 
   // single digit ULP value
   unsigned ulpBound;
@@ -684,26 +1029,25 @@ ReadULPBound(StringRef sleefName) {
   return ulpBound;
 }
 
-static Function*
-GetLeastPreciseImpl(Module & mod, const std::string & funcPrefix, const unsigned maxULPBound) {
-  Function * currBest = nullptr;
+static std::string
+GetLeastPreciseImpl(const std::vector<std::string> & funcNames, const std::string & funcPrefix, const unsigned maxULPBound) {
+  const std::string * currBest = nullptr;
   unsigned bestBound = 0;
 
   IF_DEBUG_SLEEF { errs() << "SLEEF: impl: " << funcPrefix << "\n"; }
-  for (auto & func : mod) {
-    if (func.isDeclaration()) continue;
-    if (!func.getName().startswith(funcPrefix)) continue;
+  for (const auto & funcName : funcNames) {
+    if (!StringRef(funcName).startswith(funcPrefix)) continue;
 
     // not a complete funcname match (ie "xlog" would otw match "xlog1p")
-    if ((func.getName().size() > funcPrefix.size()) &&
-        (func.getName()[funcPrefix.size()] != '_'))
+    if ((funcName.size() > funcPrefix.size()) &&
+        (funcName[funcPrefix.size()] != '_'))
     {
         continue;
     }
 
-    IF_DEBUG_SLEEF { errs() << "\t candidate: " << func.getName() << "\n"; }
+    IF_DEBUG_SLEEF { errs() << "\t candidate: " << funcName << "\n"; }
 
-    unsigned funcBound = ReadULPBound(func.getName());
+    unsigned funcBound = ReadULPBound(funcName);
     // dismiss too imprecise functions
     if (funcBound > maxULPBound) {
       IF_DEBUG_SLEEF { errs() << "discard, ulp was: " << funcBound << "\n"; }
@@ -711,21 +1055,103 @@ GetLeastPreciseImpl(Module & mod, const std::string & funcPrefix, const unsigned
 
     // accept functions with higher ULP error within maxUPLBound
     } else if (!currBest || (funcBound > bestBound)) {
-      IF_DEBUG_SLEEF { errs() << "\tOK! " << func.getName() << " with ulp bound: " << funcBound << "\n"; }
+      IF_DEBUG_SLEEF { errs() << "\tOK! " << funcName << " with ulp bound: " << funcBound << "\n"; }
       bestBound = funcBound;
-      currBest = &func;
+      currBest = &funcName;
+    }
+  }
+
+  return currBest ? *currBest : std::string();
+}
+
+// least precise implementation of @funcPrefix in library @libIndex (empty if there is none)
+static std::string
+LookupLeastPreciseImpl(int libIndex, LLVMContext & context, const std::string & funcPrefix, const unsigned maxULPBound) {
+  const auto * symbolIndex = RequestSymbolIndex(libIndex);
+  if (symbolIndex) return GetLeastPreciseImpl(*symbolIndex, funcPrefix, maxULPBound);
+
+  // no symbol table -> list the function headers of the lazy module
+  std::vector<std::string> funcNames;
+  for (auto & func : RequestLibraryModule(libIndex, context)) {
+    if (func.isDeclaration()) continue;
+    funcNames.push_back(func.getName().str());
+  }
+  return GetLeastPreciseImpl(funcNames, funcPrefix, maxULPBound);
+}
+
+std::unique_ptr<FunctionResolver>
+SleefResolverService::resolveTwoResultFunc(const TwoResultDesc & desc, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, int ulpBound, llvm::Module & destModule) {
+  // check the signature: a value operand followed by the out-parameters (if the results are not returned as a pair)
+  if (scaFuncTy.getNumParams() < 1) return nullptr;
+  auto & context = destModule.getContext();
+  auto * valTy = scaFuncTy.getParamType(0);
+  if (!valTy->isFloatTy() && !valTy->isDoubleTy()) return nullptr;
+  auto * secondTy = desc.intSecond ? Type::getInt32Ty(context) : valTy;
+
+  auto * retTy = scaFuncTy.getReturnType();
+  int numOutParams;
+  if (retTy == StructType::get(valTy, secondTy) && !desc.intSecond) numOutParams = 0;
+  else if (retTy == valTy) numOutParams = 1;
+  else if (retTy->isVoidTy() && !desc.intSecond) numOutParams = 2;
+  else return nullptr;
+  if ((int) scaFuncTy.getNumParams() != 1 + numOutParams) return nullptr;
+
+  for (int i = 1; i < (int) scaFuncTy.getNumParams(); ++i) {
+    auto * ptrTy = dyn_cast<PointerType>(scaFuncTy.getParamType(i));
+    if (!ptrTy) return nullptr;
+    bool storesSecond = (i + 1 == (int) scaFuncTy.getNumParams());
+    if (ptrTy->getElementType() != (storesSecond ? secondTy : valTy)) return nullptr;
+    // all lanes would write to the same location (VA makes the out-parameters of varying calls private)
+    if (argShapes[i].isUniform()) return nullptr;
+  }
+
+  // only pre-vectorized implementations (the VLA implementations return the pair as a vector)
+  bool doublePrecision = valTy->isDoubleTy();
+  const char * witnessName = doublePrecision ? "fabs" : "fabsf";
+  ArchFunctionList * archList = nullptr;
+  for (auto * candList : archLists) {
+    if (candList->isaIndex == SLEEF_VLA) continue;
+    for (const auto & vd : candList->commonVectorMappings) {
+      if (vd.scalarFnName == witnessName && vd.vectorWidth == vectorWidth) {
+        archList = candList;
+        break;
+      }
     }
+    if (archList) break;
+  }
+  if (!archList) return nullptr;
+
+  auto modIndex = sleefModuleIndex(archList->isaIndex, doublePrecision);
+  std::string firstName = LookupLeastPreciseImpl(modIndex, context, desc.firstImplName, ulpBound);
+  if (firstName.empty()) return nullptr;
+  std::string secondName;
+  if (desc.secondImplName) {
+    secondName = LookupLeastPreciseImpl(modIndex, context, desc.secondImplName, ulpBound);
+    if (secondName.empty()) return nullptr;
   }
 
-  return currBest;
+  Module & mod = RequestLibraryModule(modIndex, context);
+  Function * firstImpl = mod.getFunction(firstName);
+  Function * secondImpl = desc.secondImplName ? mod.getFunction(secondName) : nullptr;
+  assert(firstImpl && (!desc.secondImplName || secondImpl) && "indexed function not found in module!");
+
+  IF_DEBUG_SLEEF { errs() << "sleef: " << desc.scalarFnName << " -> " << firstName << (secondImpl ? " + " + secondName : "") << "\n"; }
+  return std::make_unique<SleefTwoResultResolver>(platInfo, destModule, desc, *firstImpl, secondImpl, archList->archSuffix, scaFuncTy, argShapes, vectorWidth);
 }
 
 std::unique_ptr<FunctionResolver>
-SleefResolverService::resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, llvm::Module & destModule) {
+SleefResolverService::resolve(llvm::StringRef funcName, llvm::FunctionType & scaFuncTy, const VectorShapeVec & argShapes, int vectorWidth, bool hasPredicate, int maxULPError, llvm::Module & destModule) {
   IF_DEBUG_SLEEF { errs() << "SLEEFResolverService: " << funcName << " for width " << vectorWidth << "\n"; }
 
   (void) hasPredicate; // FIXME use predicated versions
 
+  // call-site specific precision requirement
+  const int ulpBound = (maxULPError == DefaultULPErrorBound) ? config.maxULPErrorBound : maxULPError;
+
+  // functions with two results
+  const auto * twoResultDesc = GetTwoResultDesc(funcName);
+  if (twoResultDesc) return resolveTwoResultFunc(*twoResultDesc, scaFuncTy, argShapes, vectorWidth, ulpBound, destModule);
+
   // Otw, start looking for a SIMD-ized implementation
   ArchFunctionList * archList = nullptr;
   PlainVecDesc funcDesc;
@@ -763,10 +1189,13 @@ SleefResolverService::resolve(llvm::StringRef funcName, llvm::FunctionType & sca
   // TODO factor out
   bool isExtraFunc = funcDesc.vectorFnName.find("_extra") != std::string::npos;
   if (isExtraFunc) {
-    int modIdx = (int) isa;
-    auto *& mod = extraModules[modIdx];
-    if (!mod) mod = createModuleFromBuffer(reinterpret_cast<const char*>(extraModuleBuffers[modIdx]), extraModuleBufferLens[modIdx], context);
-    Function *vecFunc = mod->getFunction(sleefName);
+    int modIdx = extraModuleIndex(isa);
+    const auto * symbolIndex = RequestSymbolIndex(modIdx);
+    if (symbolIndex && !std::binary_search(symbolIndex->begin(), symbolIndex->end(), sleefName)) {
+      IF_DEBUG_SLEEF { errs() << "sleef: " << sleefName << " n/a in extras\n"; }
+      return nullptr;
+    }
+    Function *vecFunc = RequestLibraryModule(modIdx, context).getFunction(sleefName);
     assert(vecFunc && "mapped extra function not found in module!");
     return std::make_unique<SleefLookupResolver>(destModule, /* RNG result */ VectorShape::varying(), *vecFunc, funcDesc.vectorFnName);
   }
@@ -781,25 +1210,19 @@ SleefResolverService::resolve(llvm::StringRef funcName, llvm::FunctionType & sca
     return std::make_unique<SleefLookupResolver>(destModule, VectorShape::varying(), *vecFunc, vecFunc->getName().str());
   }
 
-  // Look in SLEEF module
+  // Look in SLEEF module (the symbol index answers without loading it)
   auto modIndex = sleefModuleIndex(isa, doublePrecision);
-  llvm::Module*& mod = sleefModules[modIndex]; // TODO const Module
-  if (!mod) {
-    mod = createModuleFromBuffer(reinterpret_cast<const char*>(sleefModuleBuffers[modIndex]), sleefModuleBufferLens[modIndex], context);
-
-    IF_DEBUG {
-      bool brokenMod = verifyModule(*mod, &errs());
-      if (brokenMod) abort();
-    }
+  std::string implName = LookupLeastPreciseImpl(modIndex, context, sleefName, ulpBound);
+  if (implName.empty()) {
+    IF_DEBUG_SLEEF { errs() << "sleef: " << sleefName << " n/a with maxULPError: " << ulpBound << "\n"; }
+    return nullptr;
   }
+  Module & mod = RequestLibraryModule(modIndex, context);
 
   if (isa == SLEEF_VLA) {
     // on-the-fly vectorization module
-    Function *vlaFunc = GetLeastPreciseImpl(*mod, sleefName, config.maxULPErrorBound);
-    if (!vlaFunc) {
-      IF_DEBUG_SLEEF { errs() << "sleef: " << sleefName << " n/a with maxULPError: " << config.maxULPErrorBound << "\n"; }
-      return nullptr;
-    }
+    Function *vlaFunc = mod.getFunction(implName);
+    assert(vlaFunc && "indexed function not found in module!");
 
     return std::make_unique<SleefVLAResolver>(platInfo, vlaFunc->getName().str(), config, *vlaFunc, argShapes, vectorWidth);
 
@@ -814,11 +1237,8 @@ SleefResolverService::resolve(llvm::StringRef funcName, llvm::FunctionType & sca
     }
 
     // we'll have to link in the function
-    Function *vecFunc = GetLeastPreciseImpl(*mod, sleefName, config.maxULPErrorBound);
-    if (!vecFunc) {
-      IF_DEBUG_SLEEF { errs() << "sleef: " << sleefName << " n/a with maxULPError: " << config.maxULPErrorBound << "\n"; }
-      return nullptr;
-    }
+    Function *vecFunc = mod.getFunction(implName);
+    assert(vecFunc && "indexed function not found in module!");
 
     std::string vecFuncName = vecFunc->getName().str() + "_" + archList->archSuffix;
     return std::make_unique<SleefLookupResolver>(destModule, resShape, *vecFunc, vecFuncName);
@@ -11,6 +11,7 @@
 #include <llvm/IR/LegacyPassManager.h>
 
 #include "llvm/IR/PassManager.h"
+#include <llvm/Analysis/BlockFrequencyInfo.h>
 #include <llvm/Analysis/BranchProbabilityInfo.h>
 #include <llvm/Analysis/LoopInfo.h>
 #include <llvm/Analysis/MemoryDependenceAnalysis.h>
@@ -162,10 +163,42 @@ VectorizerInterface::analyze(VectorizationInfo& vecInfo,
     vea.analyze();
 }
 
+// estimate the fraction of active lanes in the predicate of every region block (while the branches are still in place).
+// All lanes of the vector are active in a block with a uniform predicate. The frequency of a block relative to its closest
+// dominator with a uniform predicate is the probability that a lane executes the block, which is the expected share of
+// active lanes if lanes branch independently. This is only as good as the branch probabilities (profile data, branch weights
+// from __builtin_expect or static heuristics).
+static void
+EstimateLaneDensities(VectorizationInfo & vecInfo) {
+  auto & scalarFn = vecInfo.getScalarFunction();
+  DominatorTree domTree(scalarFn);
+  LoopInfo loopInfo(domTree);
+  BranchProbabilityInfo BPI(scalarFn, loopInfo);
+  BlockFrequencyInfo BFI(scalarFn, BPI, loopInfo);
+
+  for (auto & BB : scalarFn) {
+    if (!vecInfo.inRegion(BB)) continue;
+
+    auto * uniNode = domTree.getNode(&BB);
+    bool isVarying = false;
+    while ((uniNode->getBlock() != &vecInfo.getEntry()) &&
+           vecInfo.getVaryingPredicateFlag(*uniNode->getBlock(), isVarying) && isVarying) {
+      uniNode = uniNode->getIDom();
+    }
+
+    uint64_t uniFreq = BFI.getBlockFreq(uniNode->getBlock()).getFrequency();
+    if (uniFreq == 0) continue;
+    double density = BFI.getBlockFreq(&BB).getFrequency() / (double) uniFreq;
+    vecInfo.setLaneDensity(BB, std::min(1.0, density)); // blocks in divergent loops
+  }
+}
+
 bool
 VectorizerInterface::linearize(VectorizationInfo& vecInfo,
                  FunctionAnalysisManager & FAM) {
-    
+    // the lane densities guide the lowering of scalarized instructions (see NatBuilder::pickScalarizeMode)
+    EstimateLaneDensities(vecInfo);
+
     // TODO make this part of a new optimization phase
     // Scalar-Replication-Of-Varying-(Aggregates): split up structs of vectorizable elements to promote use of vector registers
     if (config.enableSROV) {
@@ -234,6 +267,10 @@ VectorizerInterface::linearize(VectorizationInfo& vecInfo,
     Linearizer linearizer(config, vecInfo, maskEx, FAM);
     linearizer.run();
 
+    // the linearizer keeps the dominator tree up to date but not the post dominator tree
+    auto & scalarFn = vecInfo.getScalarFunction();
+    if (auto * PDT = FAM.getCachedResult<PostDominatorTreeAnalysis>(scalarFn)) PDT->recalculate(scalarFn);
+
     IF_DEBUG {
       errs() << "--- VecInfo after Linearizer ---\n";
       vecInfo.dump();
@@ -311,7 +348,8 @@ lowerIntrinsicCall(CallInst* call) {
     case RVIntrinsic::Extract:
     case RVIntrinsic::Shuffle:
     case RVIntrinsic::Align:
-    case RVIntrinsic::Compact: {
+    case RVIntrinsic::Compact:
+    case RVIntrinsic::Expand: {
       lowerIntrinsicCall(call, [] (const CallInst* call) {
         return call->getOperand(0);
       });
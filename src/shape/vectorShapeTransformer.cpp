@@ -222,6 +222,15 @@ VectorShapeTransformer::computeShapeForInst(const Instruction& I, SmallValVec &
           return VectorShape::undef();
       }
 
+      // lanes of a varying call write different values through pointer arguments (eg sincos/modf/frexp out-parameters)
+      if (!allArgsUniform && !callee->onlyReadsMemory()) {
+        for (size_t i = 0; i < numParams; ++i) {
+          auto & op = *call.getArgOperand(i);
+          if (op.getType()->isPointerTy() && !call.onlyReadsMemory(i))
+            taintedOps.push_back(&op);
+        }
+      }
+
       // known LLVM intrinsic shapes
       if (allArgsUniform && (id == Intrinsic::lifetime_start || id == Intrinsic::lifetime_end)) {
         return VectorShape::uni();
@@ -263,6 +272,10 @@ VectorShapeTransformer::computeShapeForInst(const Instruction& I, SmallValVec &
           (valShape.greaterThanUniform() ? VectorShape::varying() : valShape));
     }
 
+    case Instruction::AtomicRMW:
+      // every lane observes a different old value, even on a uniform address
+      return VectorShape::varying();
+
     case Instruction::Select:
     {
       const Value& condition  = *I.getOperand(0);
@@ -22,6 +22,7 @@
 #include "rv/analysis/reductionAnalysis.h"
 #include "rv/analysis/costModel.h"
 #include "rv/transform/remTransform.h"
+#include "rv/annotations.h"
 
 #include "rv/config.h"
 #include "rvConfig.h"
@@ -40,8 +41,13 @@
 #include "llvm/Analysis/ScalarEvolutionExpressions.h"
 #include "llvm/Analysis/MemoryDependenceAnalysis.h"
 #include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/LoopAccessAnalysis.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
 
 #include "llvm/Transforms/Utils/Cloning.h"
+#include "llvm/Transforms/Utils/LoopVersioning.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
 
 #include "report.h"
 #include <map>
@@ -54,7 +60,8 @@ using namespace llvm;
 
 
 bool LoopVectorizer::canVectorizeLoop(Loop &L) {
-  if (!L.isAnnotatedParallel())
+  // loop versioning operates on simplified loops in LCSSA form
+  if (!L.isLoopSimplifyForm() || !L.isLCSSAForm(*DT))
     return false;
 
   BasicBlock *ExitingBlock = L.getExitingBlock();
@@ -67,6 +74,278 @@ bool LoopVectorizer::canVectorizeLoop(Loop &L) {
   return true;
 }
 
+// the widest memory access in @L (in bits)
+static
+uint64_t
+GetWidestAccessBits(Loop & L, const DataLayout & DL) {
+  uint64_t widestBits = 8;
+  for (auto * BB : L.blocks()) {
+    for (auto & inst : *BB) {
+      Type * accessTy = nullptr;
+      if (auto * load = dyn_cast<LoadInst>(&inst)) accessTy = load->getType();
+      else if (auto * store = dyn_cast<StoreInst>(&inst)) accessTy = store->getValueOperand()->getType();
+      if (!accessTy || !accessTy->isSized()) continue;
+      widestBits = std::max<uint64_t>(widestBits, DL.getTypeSizeInBits(accessTy));
+    }
+  }
+  return widestBits;
+}
+
+std::unique_ptr<LoopAccessInfo>
+LoopVectorizer::analyzeMemoryDependences(Loop & L, LoopMD & mdAnnot) {
+  if (!canVectorizeLoop(L)) {
+    if (enableDiagOutput) Report() << "loopVecPass skip " << L.getName() << " . unsupported loop structure.\n";
+    return nullptr;
+  }
+
+  auto & AA = FAM.getResult<AAManager>(*F);
+  auto & TLI = FAM.getResult<TargetLibraryAnalysis>(*F);
+  std::unique_ptr<LoopAccessInfo> accessInfo(new LoopAccessInfo(&L, SE, &TLI, &AA, DT, LI));
+
+  if (!accessInfo->canVectorizeMemory()) {
+    if (enableDiagOutput) Report() << "loopVecPass skip " << L.getName() << " . can not prove memory accesses safe.\n";
+    return nullptr;
+  }
+
+  // translate the maximal safe dependence distance into iterations of the widest access
+  iter_t depDist = ParallelDistance;
+  uint64_t maxSafeBits = accessInfo->getDepChecker().getMaxSafeRegisterWidth();
+  if (maxSafeBits != std::numeric_limits<unsigned>::max()) { // LAA: -1U means unbounded
+    uint64_t safeIterations = maxSafeBits / GetWidestAccessBits(L, F->getParent()->getDataLayout());
+    depDist = (iter_t) std::min<uint64_t>(safeIterations, ParallelDistance);
+  }
+  mdAnnot.minDepDist = depDist;
+
+  if (enableDiagOutput) {
+    Report() << "loopVecPass: " << L.getName() << " has dependence distance " << DepDistToString(depDist);
+    if (accessInfo->getRuntimePointerChecking()->Need) {
+      ReportContinue() << " with " << accessInfo->getNumRuntimePointerChecks() << " runtime alias checks";
+    }
+    ReportContinue() << "\n";
+  }
+
+  return accessInfo;
+}
+
+Loop*
+LoopVectorizer::versionLoopForAliasing(Loop & L, const LoopAccessInfo & accessInfo) {
+  LoopVersioning loopVersioning(accessInfo, &L, LI, DT, SE);
+  loopVersioning.versionLoop();
+
+  // the original loop runs if the pointers overlap, never vectorize it
+  auto * fallbackLoop = loopVersioning.getNonVersionedLoop();
+  LoopMD fallbackMD;
+  fallbackMD.alreadyVectorized = true;
+  SetLLVMLoopAnnotations(*fallbackLoop, std::move(fallbackMD));
+
+  PDT->recalculate(*F);
+  return fallbackLoop;
+}
+
+void
+LoopVectorizer::undoAliasVersioning(Loop & L, Loop & fallbackLoop) {
+  // the runtime check block branches to the fallback loop if the pointers may overlap
+  auto * fallbackPreheader = fallbackLoop.getLoopPreheader();
+  auto * checkBlock = fallbackPreheader->getSinglePredecessor();
+  auto * checkBr = cast<BranchInst>(checkBlock->getTerminator());
+  auto * versionedEntry = checkBr->getSuccessor(0) == fallbackPreheader ? checkBr->getSuccessor(1) : checkBr->getSuccessor(0);
+  BranchInst::Create(versionedEntry, checkBr);
+  checkBr->eraseFromParent();
+
+  // the versioned loop did not get any no-alias metadata (LoopVersioning::annotateLoopWithNoAlias), so it is equivalent to the original loop
+  SmallVector<BasicBlock*, 16> deadBlocks(fallbackLoop.blocks().begin(), fallbackLoop.blocks().end());
+  deadBlocks.push_back(fallbackPreheader);
+
+  SE->forgetLoop(&fallbackLoop);
+  SE->forgetLoop(&L);
+  for (auto * BB : deadBlocks) LI->removeBlock(BB);
+  if (auto * parentLoop = fallbackLoop.getParentLoop()) {
+    parentLoop->removeChildLoop(&fallbackLoop);
+  } else {
+    LI->removeLoop(std::find(LI->begin(), LI->end(), &fallbackLoop));
+  }
+  LI->destroy(&fallbackLoop);
+  DeleteDeadBlocks(deadBlocks);
+
+  DT->recalculate(*F);
+  PDT->recalculate(*F);
+}
+
+// whether @val can be re-computed from the header phis of @L (and loop invariant values) at the top of the header
+static
+bool
+IsComputableInHeader(Value & val, Loop & L) {
+  auto * inst = dyn_cast<Instruction>(&val);
+  if (!inst || !L.contains(inst)) return true;
+  if (isa<PHINode>(inst)) return inst->getParent() == L.getHeader();
+
+  bool supported = isa<GetElementPtrInst>(inst) || isa<CastInst>(inst);
+  switch (inst->getOpcode()) {
+    case Instruction::Add:
+    case Instruction::Sub:
+    case Instruction::Mul:
+    case Instruction::Shl:
+      supported = true;
+      break;
+    default:
+      break;
+  }
+  if (!supported) return false;
+
+  for (auto & op : inst->operands()) {
+    if (!IsComputableInHeader(*op.get(), L)) return false;
+  }
+  return true;
+}
+
+// re-compute @val (of loop @L) in the peeled loop @peelMap at the insertion point of @builder
+static
+Value&
+ReplicateInPeeledHeader(Value & val, Loop & L, ValueToValueMapTy & peelMap, ValueToValueMapTy & replMap, IRBuilder<> & builder) {
+  auto * inst = dyn_cast<Instruction>(&val);
+  if (!inst || !L.contains(inst)) return val;
+  if (isa<PHINode>(inst)) return *peelMap[inst];
+
+  auto itRepl = replMap.find(inst);
+  if (itRepl != replMap.end()) return *itRepl->second;
+
+  auto * clone = inst->clone();
+  for (size_t i = 0; i < inst->getNumOperands(); ++i) {
+    clone->setOperand(i, &ReplicateInPeeledHeader(*inst->getOperand(i), L, peelMap, replMap, builder));
+  }
+  builder.Insert(clone, inst->getName() + ".peel");
+  replMap[inst] = clone;
+  return *clone;
+}
+
+// the pointer of a load or store in @L that advances by its access size (@accessSize) in every iteration
+static
+Instruction*
+FindContiguousStream(Loop & L, ScalarEvolution & SE, const DataLayout & DL, uint64_t & accessSize) {
+  // prefer stores: misaligned stores are the more costly ones
+  for (int pickStores = 1; pickStores >= 0; --pickStores) {
+    for (auto * BB : L.blocks()) {
+      for (auto & inst : *BB) {
+        Value * ptr = nullptr;
+        Type * accessTy = nullptr;
+        if (auto * store = dyn_cast<StoreInst>(&inst)) {
+          if (!pickStores) continue;
+          ptr = store->getPointerOperand();
+          accessTy = store->getValueOperand()->getType();
+        } else if (auto * load = dyn_cast<LoadInst>(&inst)) {
+          if (pickStores) continue;
+          ptr = load->getPointerOperand();
+          accessTy = load->getType();
+        } else {
+          continue;
+        }
+
+        auto * ptrInst = dyn_cast<Instruction>(ptr);
+        if (!ptrInst || !L.contains(ptrInst)) continue;
+
+        uint64_t size = DL.getTypeStoreSize(accessTy);
+        if (!isPowerOf2_64(size)) continue;
+
+        auto * addRec = dyn_cast<SCEVAddRecExpr>(SE.getSCEV(ptr));
+        if (!addRec || addRec->getLoop() != &L || !addRec->isAffine()) continue;
+        auto * step = dyn_cast<SCEVConstant>(addRec->getStepRecurrence(SE));
+        if (!step || step->getAPInt() != size) continue;
+
+        if (!IsComputableInHeader(*ptrInst, L)) continue;
+
+        accessSize = size;
+        return ptrInst;
+      }
+    }
+  }
+  return nullptr;
+}
+
+Instruction*
+LoopVectorizer::peelForAlignment(Loop & L, int VectorWidth) {
+  auto & DL = F->getParent()->getDataLayout();
+  auto * entryBlock = L.getLoopPreheader();
+  auto * exitBlock = L.getExitBlock();
+  if (!entryBlock || !exitBlock || !L.getExitingBlock() || !L.isLCSSAForm(*DT)) {
+    if (enableDiagOutput) Report() << "loopVecPass: can not peel " << L.getName() << " for alignment. unsupported loop structure.\n";
+    return nullptr;
+  }
+
+  uint64_t accessSize = 0;
+  auto * streamPtr = FindContiguousStream(L, *SE, DL, accessSize);
+  if (!streamPtr) {
+    if (enableDiagOutput) Report() << "loopVecPass: can not peel " << L.getName() << " for alignment. no contiguous access stream.\n";
+    return nullptr;
+  }
+
+  // align to the vector size (at most a cache line)
+  uint64_t alignment = std::min<uint64_t>(VectorWidth * accessSize, 64);
+  if (alignment <= accessSize) return nullptr;
+
+// the prologue loop enters the vector loop through a new pre-header
+  auto * header = L.getHeader();
+  auto * mainPH = SplitEdge(entryBlock, header, DT, LI);
+  mainPH->setName(L.getName() + ".peeled");
+
+// clone the loop as the peeling prologue
+  ValueToValueMapTy peelMap;
+  SmallVector<BasicBlock*, 8> peelBlocks;
+  auto * peelLoop = cloneLoopWithPreheader(mainPH, entryBlock, &L, peelMap, ".peel", LI, DT, peelBlocks);
+  remapInstructionsInBlocks(peelBlocks, peelMap);
+  auto * peelPH = cast<BasicBlock>(peelMap[mainPH]);
+  entryBlock->getTerminator()->replaceUsesOfWith(mainPH, peelPH);
+
+  // the prologue may finish the whole loop
+  auto * latch = L.getLoopLatch();
+  auto * peelLatch = cast<BasicBlock>(peelMap[latch]);
+  for (auto & inst : *exitBlock) {
+    auto * exitPhi = dyn_cast<PHINode>(&inst);
+    if (!exitPhi) break;
+    auto * inVal = exitPhi->getIncomingValueForBlock(latch);
+    Value * peelVal = peelMap.lookup(inVal);
+    exitPhi->addIncoming(peelVal ? peelVal : inVal, peelLatch);
+  }
+
+// leave the prologue once the stream is aligned
+  auto * peelHeader = cast<BasicBlock>(peelMap[header]);
+  auto * peelBody = SplitBlock(peelHeader, peelHeader->getFirstNonPHI(), DT, LI);
+
+  IRBuilder<> builder(peelHeader->getTerminator());
+  ValueToValueMapTy replMap;
+  auto & peelPtr = ReplicateInPeeledHeader(*streamPtr, L, peelMap, replMap, builder);
+  auto * intPtrTy = DL.getIntPtrType(peelPtr.getType());
+  auto * misalign = builder.CreateAnd(builder.CreatePtrToInt(&peelPtr, intPtrTy), ConstantInt::get(intPtrTy, alignment - 1), "misalign");
+  auto * isAligned = builder.CreateICmpEQ(misalign, ConstantInt::get(intPtrTy, 0), "aligned");
+
+  auto * peelHeadTerm = peelHeader->getTerminator();
+  BranchInst::Create(mainPH, peelBody, isAligned, peelHeadTerm);
+  peelHeadTerm->eraseFromParent();
+
+  // the loop starts from the first aligned iteration
+  IRBuilder<> phBuilder(mainPH, mainPH->begin());
+  for (auto & inst : *header) {
+    auto * phi = dyn_cast<PHINode>(&inst);
+    if (!phi) break;
+    auto * peelPhi = cast<PHINode>(peelMap[phi]);
+    auto * startPhi = phBuilder.CreatePHI(phi->getType(), 1, phi->getName() + ".peeled");
+    startPhi->addIncoming(peelPhi, peelHeader);
+    phi->setIncomingValue(phi->getBasicBlockIndex(mainPH), startPhi);
+  }
+
+  // never vectorize the prologue
+  LoopMD peelMD;
+  peelMD.alreadyVectorized = true;
+  SetLLVMLoopAnnotations(*peelLoop, std::move(peelMD));
+
+  SE->forgetLoop(&L);
+  DT->recalculate(*F);
+  PDT->recalculate(*F);
+
+  SetAlignmentHint(*streamPtr, alignment);
+  if (enableDiagOutput) Report() << "loopVecPass: peeling " << L.getName() << " until " << streamPtr->getName() << " is aligned to " << alignment << " bytes\n";
+  return streamPtr;
+}
+
 int
 LoopVectorizer::getTripAlignment(Loop & L) {
   int tripCount = getTripCount(L);
@@ -96,26 +375,82 @@ LoopVectorizer::getTripCount(Loop &L) {
 }
 
 Loop*
-LoopVectorizer::transformToVectorizableLoop(Loop &L, int VectorWidth, int tripAlign, ValueSet & uniformOverrides) {
+LoopVectorizer::transformToVectorizableLoop(Loop &L, int VectorWidth, int tripAlign, int minTripCount, ValueSet & uniformOverrides, ValueSet & derefAccesses) {
   IF_DEBUG { errs() << "\tCreating scalar remainder Loop for " << L.getName() << "\n"; }
 
+  // fold the remainder into the vector loop (unless the trip count is a multiple of the vector width)
+  bool foldTail = config.enableTailFolding && (tripAlign % VectorWidth != 0);
+
   // try to applu the remainder transformation
-  RemainderTransform remTrans(*F, *DT, *PDT, *LI, *reda, PB);
-  auto * preparedLoop = remTrans.createVectorizableLoop(L, uniformOverrides, VectorWidth, tripAlign);
+  RemainderTransform remTrans(*F, *DT, *PDT, *LI, *reda, PB, SE);
+  auto * preparedLoop = remTrans.createVectorizableLoop(L, uniformOverrides, derefAccesses, VectorWidth, tripAlign, minTripCount, foldTail);
 
   return preparedLoop;
 }
 
+// whether the running value of @red can be computed as a prefix scan in the vector loop
+// supported are chains "s.next = s [[op]] x" that execute in every iteration and whose running value is only observed after x is available
+static
+bool
+IsSupportedScan(Loop & L, Reduction & red, DominatorTree & DT, bool enableDiagOutput) {
+  if (red.kind == RedKind::Top || red.kind == RedKind::Bot) return false;
+
+  PHINode * phi = nullptr;
+  for (auto & inst : *L.getHeader()) {
+    auto * headerPhi = dyn_cast<PHINode>(&inst);
+    if (!headerPhi) break;
+    if (red.elements.count(headerPhi)) { phi = headerPhi; break; }
+  }
+  if (!phi || red.elements.size() != 2) {
+    if (enableDiagOutput) Report() << "scan: not a single operation chain\n";
+    return false;
+  }
+
+  auto * reductor = dyn_cast<BinaryOperator>(phi->getIncomingValueForBlock(L.getLoopLatch()));
+  if (!reductor || !red.elements.count(reductor) ||
+      reductor->getOpcode() == Instruction::Sub || reductor->getOpcode() == Instruction::FSub) {
+    if (enableDiagOutput) Report() << "scan: unsupported scan operation\n";
+    return false;
+  }
+
+  // the scan must not be predicated
+  if (!DT.dominates(reductor->getParent(), L.getLoopLatch())) {
+    if (enableDiagOutput) Report() << "scan: scan operation does not execute in every iteration " << *reductor << "\n";
+    return false;
+  }
+
+  // the exclusive running value is materialized once the scan input x is known
+  int phiIdx = reductor->getOperand(0) == phi ? 0 : 1;
+  auto * inputInst = dyn_cast<Instruction>(reductor->getOperand(1 - phiIdx));
+  if (!inputInst || !L.contains(inputInst->getParent())) return true;
+
+  for (auto * user : phi->users()) {
+    auto * userInst = cast<Instruction>(user);
+    if (userInst == reductor || !L.contains(userInst->getParent())) continue;
+    if (!DT.dominates(inputInst, userInst)) {
+      if (enableDiagOutput) Report() << "scan: running value used before the scan input " << *userInst << "\n";
+      return false;
+    }
+  }
+
+  return true;
+}
+
 static
 bool
-IsSupportedReduction(Loop & L, Reduction & red) {
-  // check that all users of the reduction are either (a) part of it or (b) outside the loop
+IsSupportedReduction(Loop & L, Reduction & red, DominatorTree & DT, bool enableDiagOutput) {
+  // in-loop users observe the running value
+  if (red.isScan()) return IsSupportedScan(L, red, DT, enableDiagOutput);
+
+  // check that all users of the reduction are either (a) part of it, (b) index selects of an arg reduction or (c) outside the loop
   for (auto * inst : red.elements) {
     for (auto itUser : inst->users()) {
       auto * userInst = dyn_cast<Instruction>(itUser);
       if (!userInst) return false; // unsupported
+      bool argUser = false;
+      for (auto * argRed : red.argReds) argUser |= argRed->contains(*userInst);
       if (L.contains(userInst->getParent()) &&
-        !red.elements.count(userInst))  {
+        !red.elements.count(userInst) && !argUser)  {
         errs() << "Unsupported user of reduction: "; Dump(*userInst); 
         return false;
       }
@@ -125,6 +460,38 @@ IsSupportedReduction(Loop & L, Reduction & red) {
   return true;
 }
 
+// pin the shapes of the header phis and the exit condition of @L as the vector loop would see them.
+// Returns false if a header phi is not a recognized recurrence.
+static
+bool
+PinSpeculativeShapes(Loop & L, ReductionAnalysis & reda, VectorizationInfo & vecInfo) {
+  const int vectorWidth = vecInfo.getVectorWidth();
+  for (auto & inst : *L.getHeader()) {
+    auto * phi = dyn_cast<PHINode>(&inst);
+    if (!phi) break;
+
+    VectorShape phiShape;
+    if (auto * pat = reda.getStrideInfo(*phi)) {
+      phiShape = pat->getShape(vectorWidth);
+    } else if (auto * redInfo = reda.getReductionInfo(*phi)) {
+      phiShape = redInfo->getShape(vectorWidth);
+    } else {
+      return false;
+    }
+    if (phiShape.isDefined()) vecInfo.setPinnedShape(*phi, phiShape);
+  }
+
+  // the remainder transform makes the exit condition of the vector loop uniform
+  auto * exitingBlock = L.getLoopLatch();
+  auto * exitBranch = exitingBlock ? dyn_cast<BranchInst>(exitingBlock->getTerminator()) : nullptr;
+  if (exitBranch && exitBranch->isConditional()) {
+    auto * exitCond = dyn_cast<Instruction>(exitBranch->getCondition());
+    if (exitCond && L.contains(exitCond)) vecInfo.setPinnedShape(*exitCond, VectorShape::uni());
+  }
+
+  return true;
+}
+
 bool
 LoopVectorizer::vectorizeLoop(Loop &L) {
 // check the dependence distance of this loop
@@ -132,10 +499,23 @@ LoopVectorizer::vectorizeLoop(Loop &L) {
 
   if (enableDiagOutput) { Report() << "loopVecPass: "; mdAnnot.print(ReportContinue()) << "\n"; }
 
-  // only trigger on annotated loops
+  // only trigger on annotated loops (unless auto-vectorization is enabled)
+  std::unique_ptr<LoopAccessInfo> accessInfo;
   if (!mdAnnot.vectorizeEnable.safeGet(false)) {
-    if (enableDiagOutput) Report() << "loopVecPass skip " << L.getName() << " . not explicitly triggered.\n";
-    return false;
+    if (!config.enableAutoVectorization || mdAnnot.vectorizeEnable.isSet()) {
+      if (enableDiagOutput) Report() << "loopVecPass skip " << L.getName() << " . not explicitly triggered.\n";
+      return false;
+    }
+    if (mdAnnot.alreadyVectorized.safeGet(false)) {
+      if (enableDiagOutput) Report() << "loopVecPass skip " << L.getName() << " . already vectorized.\n";
+      return false;
+    }
+
+    // unannotated loop: check its memory dependences (at runtime, if necessary)
+    if (!mdAnnot.minDepDist.isSet()) {
+      accessInfo = analyzeMemoryDependences(L, mdAnnot);
+      if (!accessInfo) return false;
+    }
   }
 
   // skip if already vectorized
@@ -145,6 +525,12 @@ LoopVectorizer::vectorizeLoop(Loop &L) {
     return false;
   }
 
+  // data-dependent early exits
+  if (!L.getExitingBlock() && !config.enableEarlyExits) {
+    if (enableDiagOutput) Report() << "loopVecPass skip " << L.getName() << " . loop has early exits.\n";
+    return false;
+  }
+
   iter_t depDist = mdAnnot.minDepDist.safeGet(ParallelDistance);
 
   // skip if iteration dependence distance precludes vectorization
@@ -167,14 +553,34 @@ LoopVectorizer::vectorizeLoop(Loop &L) {
     if (enableDiagOutput) Report() << "loopVecPass: with user-provided vector width (RV_FORCE_WIDTH=" << VectorWidth << ")\n";
   }
 
+  // a fixed width must not exceed the dependence distance
+  if (hasFixedWidth && VectorWidth > depDist) {
+    if (enableDiagOutput) Report() << "loopVecPass: clamping vector width " << VectorWidth << " to the dependence distance " << depDist << "\n";
+    VectorWidth = (int) depDist;
+  }
+
+// analyze the recurrsnce patterns of this loop
+  reda.reset(new ReductionAnalysis(*F, FAM));
+  reda->analyze(L);
+
 // pick a vectorization factor (unless user override is set)
+  int minTripCount = 0; // vector loop guard threshold
+  int narrowWidth = 1; // width of the vectorized remainder loop (multi-versioning)
+  int narrowMinTripCount = 0;
+
+  CostModel costModel(vectorizer->getPlatformInfo(), config);
+  LoopRegion tmpLoopRegionImpl(L);
+  Region tmpLoopRegion(tmpLoopRegionImpl);
+  CostModel::ShapeAnalysis analyzeShapes = [&](VectorizationInfo & tmpVecInfo) {
+    if (!PinSpeculativeShapes(L, *reda, tmpVecInfo)) return false;
+    vectorizer->analyze(tmpVecInfo, FAM);
+    return true;
+  };
+
   if (!hasFixedWidth) {
     size_t initialWidth = VectorWidth == 0 ? depDist : VectorWidth;
 
-    CostModel costModel(vectorizer->getPlatformInfo(), config);
-    LoopRegion tmpLoopRegionImpl(L);
-    Region tmpLoopRegion(tmpLoopRegionImpl);
-    size_t refinedWidth = costModel.pickWidthForRegion(tmpLoopRegion, initialWidth); // TODO run VA first
+    size_t refinedWidth = costModel.pickWidthForRegion(tmpLoopRegion, initialWidth, analyzeShapes);
 
     if (refinedWidth <= 1) {
       if (enableDiagOutput) { Report() << "loopVecPass, costModel: vectorization not beneficial\n"; }
@@ -187,6 +593,63 @@ LoopVectorizer::vectorizeLoop(Loop &L) {
       }
       VectorWidth = refinedWidth;
     }
+
+    // multi-versioning: short trip counts run in a narrower vector loop
+    if (config.enableMultiVersioning && (tripAlign % VectorWidth != 0)) {
+      narrowWidth = costModel.pickWidthForRegion(tmpLoopRegion, VectorWidth / 2, analyzeShapes);
+      minTripCount = costModel.getMinProfitableTripCount(tmpLoopRegion, VectorWidth, narrowWidth, analyzeShapes);
+      if (narrowWidth > 1) {
+        narrowMinTripCount = costModel.getMinProfitableTripCount(tmpLoopRegion, narrowWidth, 1, analyzeShapes);
+      }
+
+      if (minTripCount == 0) {
+        // the narrow loop is always preferable
+        VectorWidth = narrowWidth;
+        minTripCount = narrowMinTripCount;
+        narrowWidth = 1;
+      }
+      if (VectorWidth <= 1) {
+        if (enableDiagOutput) { Report() << "loopVecPass, costModel: vectorization not beneficial\n"; }
+        return false;
+      }
+      if (enableDiagOutput) {
+        Report() << "loopVecPass, costModel: multi-versioning with VW " << VectorWidth << " from " << minTripCount << " iterations";
+        if (narrowWidth > 1) ReportContinue() << " and VW " << narrowWidth << " from " << narrowMinTripCount << " iterations";
+        ReportContinue() << "\n";
+      }
+    }
+
+  }
+
+// interleave independent vector iterations to hide the latency of reductions
+  // (after the width decisions above, which cost a single vector iteration)
+  int interleaveCount = 1;
+  if (mdAnnot.interleaveCount.isSet()) {
+    interleaveCount = mdAnnot.interleaveCount.get();
+  } else if (!hasFixedWidth) {
+    interleaveCount = costModel.pickInterleaveCount(tmpLoopRegion, VectorWidth, analyzeShapes);
+  }
+
+  // widen the loop by the interleave count (without exceeding the dependence distance).
+  // The backend legalizes each vector into interleaveCount native vectors with independent accumulators that get combined after the loop.
+  interleaveCount = std::max<iter_t>(1, std::min<iter_t>(interleaveCount, depDist / VectorWidth));
+  if (interleaveCount > 1) {
+    if (enableDiagOutput) Report() << "loopVecPass: interleaving " << interleaveCount << " vector iterations of width " << VectorWidth << "\n";
+
+    // multi-versioning: remainders of the interleaved loop still run at the costed width
+    if (config.enableMultiVersioning && (narrowWidth <= 1) && (tripAlign % (VectorWidth * interleaveCount) != 0)) {
+      narrowWidth = VectorWidth;
+      narrowMinTripCount = minTripCount;
+    }
+    VectorWidth *= interleaveCount;
+  }
+
+// half-width epilogue: vectorize the scalar remainder loop at half the vector width
+  // (a folded tail leaves no remainder loop behind)
+  if (config.enableHalfWidthEpilogue && !config.enableTailFolding && !config.enableMultiVersioning &&
+      (VectorWidth >= 4) && (tripAlign % VectorWidth != 0)) {
+    narrowWidth = VectorWidth / 2;
+    narrowMinTripCount = 0;
   }
 
   Report() << "loopVecPass: Vectorize " << L.getName()
@@ -194,13 +657,50 @@ LoopVectorizer::vectorizeLoop(Loop &L) {
            << " , Dependence Distance: " << DepDistToString(depDist)
            << " and TripAlignment: " << tripAlign << "\n";
 
-// analyze the recurrsnce patterns of this loop
-  reda.reset(new ReductionAnalysis(*F, FAM));
-  reda->analyze(L);
+// runtime alias checks: the vector loop only runs if the accessed memory ranges do not overlap
+  Loop * aliasFallbackLoop = nullptr;
+  if (accessInfo && (accessInfo->getRuntimePointerChecking()->Need || !accessInfo->getPSE().getUnionPredicate().isAlwaysTrue())) {
+    if (enableDiagOutput) Report() << "loopVecPass: versioning " << L.getName() << " on " << accessInfo->getNumRuntimePointerChecks() << " runtime alias checks\n";
+    aliasFallbackLoop = versionLoopForAliasing(L, *accessInfo);
+  }
+
+// alignment peeling: a scalar prologue runs until a contiguous access stream is aligned
+  Instruction * alignedStream = nullptr;
+  if (config.enableAlignmentPeeling) {
+    alignedStream = peelForAlignment(L, VectorWidth);
+    if (alignedStream) tripAlign = 1; // the prologue consumes a dynamic number of iterations
+  }
+
+  bool vectorized = vectorizeLoopWithWidth(L, VectorWidth, tripAlign, minTripCount);
+
+  // the scalar remainder loop is not aligned
+  if (alignedStream) SetAlignmentHint(*alignedStream, 1);
+
+  if (!vectorized) {
+    if (aliasFallbackLoop) undoAliasVersioning(L, *aliasFallbackLoop);
+    return false;
+  }
+
+// vectorize the remainder loop at the narrow width (multi-versioning, half-width epilogue)
+  if (narrowWidth > 1) {
+    Report() << "loopVecPass: Vectorize remainder of " << L.getName()
+             << " with VW: " << narrowWidth
+             << " (full width loop entered from " << minTripCount << " iterations"
+             << ", narrow loop from " << narrowMinTripCount << ")\n";
+
+    reda.reset(new ReductionAnalysis(*F, FAM));
+    reda->analyze(L);
+    vectorizeLoopWithWidth(L, narrowWidth, 1, narrowMinTripCount);
+  }
+
+  return true;
+}
 
+bool
+LoopVectorizer::vectorizeLoopWithWidth(Loop &L, int VectorWidth, int tripAlign, int minTripCount) {
 // match vector loop structure
-  ValueSet uniOverrides;
-  auto * PreparedLoop = transformToVectorizableLoop(L, VectorWidth, tripAlign, uniOverrides);
+  ValueSet uniOverrides, derefAccesses;
+  auto * PreparedLoop = transformToVectorizableLoop(L, VectorWidth, tripAlign, minTripCount, uniOverrides, derefAccesses);
   if (!PreparedLoop) {
     Report() << "loopVecPass: Can not prepare vectorization of the loop\n";
     return false;
@@ -251,7 +751,7 @@ LoopVectorizer::vectorizeLoop(Loop &L) {
         return false;
       }
 
-      if (!IsSupportedReduction(*PreparedLoop, *redInfo)) {
+      if (!IsSupportedReduction(*PreparedLoop, *redInfo, *DT, enableDiagOutput)) {
         Report() << " unsupported reduction: "; redInfo->print(ReportContinue()); ReportContinue() << "\n";
         return false;
       }
@@ -285,6 +785,11 @@ LoopVectorizer::vectorizeLoop(Loop &L) {
     vecInfo.setPinnedShape(*val, VectorShape::uni());
   }
 
+  // masked accesses through these pointers can load the whole vector
+  for (auto * ptr : derefAccesses) {
+    vecInfo.addDereferenceableAccess(*ptr);
+  }
+
   //DT.verify();
   //LI.verify(DT);
 
@@ -320,8 +825,8 @@ LoopVectorizer::vectorizeLoop(Loop &L) {
   // vectorize the prepared loop embedding it in its context
   ValueToValueMapTy vecMap;
 
-  ScalarEvolutionAnalysis adhocAnalysis;
-  adhocAnalysis.run(*F, FAM);
+  // cached SCEVs of the prepared loop predate linearization
+  SE->forgetLoop(PreparedLoop);
 
   bool vectorizeOk = vectorizer->vectorize(vecInfo, FAM, &vecMap);
   if (!vectorizeOk)
@@ -393,8 +898,10 @@ bool LoopVectorizer::runOnFunction(Function &F) {
 // setup PlatformInfo
   PlatformInfo platInfo(*F.getParent(), &tti, &tli);
 
-  // TODO translate fast-math flag to ULP error bound
+  // call sites with fast-math flags may relax config.maxULPErrorBound (see GetCallSiteULPBound)
   if (!CheckFlag("RV_NO_SLEEF")) { addSleefResolver(config, platInfo); }
+  // vector math library (-fveclib), ranked against SLEEF by cost
+  addTLIResolver(config, platInfo);
 
   // enable inter-procedural vectorization
   if (config.enableGreedyIPV) {
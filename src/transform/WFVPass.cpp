@@ -194,6 +194,7 @@ WFVPass::runOnModule(Module & M) {
   // configure platInfo
   PlatformInfo platInfo(M, &TTI, &TLI);
   addSleefResolver(rvConfig, platInfo);
+  addTLIResolver(rvConfig, platInfo);
 
   // add mappings for recursive vectorization
   for (auto & job : wfvJobs) {
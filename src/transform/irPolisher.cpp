@@ -180,8 +180,8 @@ Value *IRPolisher::lowerIntrinsicCall(llvm::CallInst* callInst) {
       : builder.CreateICmpEQ(castedArg, Constant::getAllOnesValue(castTy));
   }
 
-  // Replace LLVM's gather intrinsic by an AVX2 gather
-  if (isGather) {
+  // Replace LLVM's gather intrinsic by an AVX2 gather (AVX-512 gathers take a mask register)
+  if (isGather && !config.hasMaskRegisters()) {
     // Only support 32bit gathers
     auto vecTy = callInst->getType();
     if (GetVectorNumElements(vecTy) != 8 ||
@@ -561,6 +561,11 @@ bool IRPolisher::polish() {
     return false; // requires >= AVX
   }
 
+  // with mask registers, <n x i1> is a machine type: keep the masks and only lower the mask reductions (kortest)
+  if (config.hasMaskRegisters()) {
+    return lowerIntrinsicCalls();
+  }
+
   IF_DEBUG { errs() << "Starting polishing phase\n"; }
 
   // Run InstCombine to perform peephole opts
@@ -618,6 +623,16 @@ bool IRPolisher::polish() {
   // This happens when doing comparisons with objects that do not
   // map to SSE/AVX registers (e.g. fcmp <8 x double> ...). We handle
   // this by emitting generic LLVM IR.
+  lowerIntrinsicCalls();
+
+  if (visitedInsts.size() > 0) {
+    Report() << "IRPolish: polished " << visitedInsts.size() << " instruction(s)\n";
+  }
+
+  return visitedInsts.size() > 0;
+}
+
+bool IRPolisher::lowerIntrinsicCalls() {
   std::vector<CallInst*> loweredCalls;
   for (auto it = inst_begin(F), end = inst_end(F); it != end; ++it) {
     auto inst = &*it;
@@ -629,12 +644,7 @@ bool IRPolisher::polish() {
     }
   }
   for (auto call : loweredCalls) call->eraseFromParent();
-
-  if (visitedInsts.size() > 0) {
-    Report() << "IRPolish: polished " << visitedInsts.size() << " instruction(s)\n";
-  }
-
-  return visitedInsts.size() > 0;
+  return !loweredCalls.empty();
 }
 
 
@@ -42,8 +42,9 @@ struct LoopCloner {
     auto * preTerm = loopPreHead->getTerminator();
     auto & loopHead = *L.getHeader();
 
-    auto * loopExiting = L.getExitingBlock();
-    assert(loopExiting && " can only clone single exit loops");
+    // the latch exits the loop (any other exiting blocks are early exits)
+    auto * loopExiting = L.getLoopLatch();
+    assert(loopExiting && L.isLoopExiting(loopExiting) && " can only clone loops that exit from their latch");
 
     auto * splitBranch = BranchInst::Create(&loopHead, &loopHead, ConstantInt::getTrue(loopHead.getContext()), loopPreHead);
 
@@ -315,7 +315,7 @@ MaskExpander::requestBlockMask(BasicBlock & BB) {
 
   // check if we post-dominate our idom (optimization)
   auto &DT = FAM.getResult<DominatorTreeAnalysis>(vecInfo.getScalarFunction());
-  auto &PDT = FAM.getResult<DominatorTreeAnalysis>(vecInfo.getScalarFunction());
+  auto &PDT = FAM.getResult<PostDominatorTreeAnalysis>(vecInfo.getScalarFunction());
   auto * domNode = DT.getNode(&BB);
   auto &idomBlock = *domNode->getIDom()->getBlock();
 
@@ -39,6 +39,8 @@ CreateReductInst(IRBuilder<> & builder, RedKind redKind, Value & firstArg, Value
         return *cast<Instruction>(builder.CreateOr(&firstArg, &secondArg, secondArg.getName() + ".r"));
     case RedKind::And:
         return *cast<Instruction>(builder.CreateAnd(&firstArg, &secondArg, secondArg.getName() + ".r"));
+    case RedKind::Xor:
+        return *cast<Instruction>(builder.CreateXor(&firstArg, &secondArg, secondArg.getName() + ".r"));
 
     case RedKind::Mul:
       if (isFloat) {
@@ -55,6 +57,11 @@ CreateReductInst(IRBuilder<> & builder, RedKind redKind, Value & firstArg, Value
     case RedKind::SMin:
       return CreateMinMax(builder, firstArg, secondArg, true, redKind == RedKind::SMin);
 
+    case RedKind::FMax:
+      return *cast<Instruction>(builder.CreateMaxNum(&firstArg, &secondArg, secondArg.getName() + ".r"));
+    case RedKind::FMin:
+      return *cast<Instruction>(builder.CreateMinNum(&firstArg, &secondArg, secondArg.getName() + ".r"));
+
     default:
       abort(); // unsupported reduction
   }
@@ -102,6 +109,9 @@ GetIntrinsicID(RedKind kind, Type & elemTy, bool &oHasInitVal, bool & oRequiresR
     }
     case RedKind::And: return Intrinsic::experimental_vector_reduce_and;
     case RedKind::Or: return Intrinsic::experimental_vector_reduce_or;
+    case RedKind::Xor: return Intrinsic::experimental_vector_reduce_xor;
+    case RedKind::FMax: return Intrinsic::experimental_vector_reduce_fmax;
+    case RedKind::FMin: return Intrinsic::experimental_vector_reduce_fmin;
     case RedKind::SMax: return elemTy.isFloatingPointTy() ? Intrinsic::experimental_vector_reduce_fmax : Intrinsic::experimental_vector_reduce_smax;
     case RedKind::UMax: return elemTy.isFloatingPointTy() ? Intrinsic::experimental_vector_reduce_fmax : Intrinsic::experimental_vector_reduce_umax;
     case RedKind::SMin: return elemTy.isFloatingPointTy() ? Intrinsic::experimental_vector_reduce_fmin : Intrinsic::experimental_vector_reduce_smin;
@@ -200,6 +210,29 @@ CreateVectorReduce(Config & config, IRBuilder<> & builder, RedKind redKind, Valu
   }
 }
 
+Value &
+CreateVectorScan(IRBuilder<> & builder, RedKind redKind, Value & vecVal) {
+  auto & vecTy = *cast<FixedVectorType>(vecVal.getType());
+  const int vecWidth = vecTy.getNumElements();
+  auto * neutralVec = builder.CreateVectorSplat(vecWidth, &GetNeutralElement(redKind, *vecTy.getElementType()));
+
+  // 0 1 2 3 4 5 6 7
+  // n 0 1 2 3 4 5 6  (shift = 1)
+  // n n 0 1 2 3 4 5  (shift = 2)
+  // n n n n 0 1 2 3  (shift = 4)
+  Value * accu = &vecVal;
+  for (int shift = 1; shift < vecWidth; shift *= 2) {
+    SmallVector<int, 16> shiftIndices;
+    for (int i = 0; i < vecWidth; ++i) {
+      shiftIndices.push_back(i < shift ? i : vecWidth + i - shift);
+    }
+    auto * shifted = builder.CreateShuffleVector(neutralVec, accu, shiftIndices, "scan_shift");
+    accu = &CreateReductInst(builder, redKind, *accu, *shifted);
+  }
+
+  return *accu;
+}
+
 Value &
 CreateExtract(IRBuilder<> & builder, Value & vecVal, int laneOffset) {
   auto * vecTy = dyn_cast<VectorType>(vecVal.getType());
@@ -13,16 +13,20 @@
 #include "rv/vectorizationInfo.h"
 #include "rv/transform/loopCloner.h"
 #include "rv/utils.h"
+#include "rv/intrinsics.h"
 
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Dominators.h"
 #include "llvm/IR/Instructions.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
 
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/Analysis/PostDominators.h"
 #include "llvm/Analysis/ScalarEvolution.h"
 #include "llvm/Analysis/ScalarEvolutionExpressions.h"
 #include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include "llvm/Analysis/ValueTracking.h"
+#include "llvm/Analysis/Loads.h"
 
 #include "rvConfig.h"
 #include "rv/rvDebug.h"
@@ -65,6 +69,21 @@ UnwindCasts(Value* val) {
   return val;
 }
 
+// whether the increment of the stride pattern @sp does not wrap in the signed sense
+// (an inbounds gep can still cross the sign boundary of the address space)
+static bool
+HasNoSignedWrap(const StridePattern & sp) {
+  if (isa<GetElementPtrInst>(sp.reductor)) return false;
+  return sp.reductor->hasNoSignedWrap();
+}
+
+// whether the increment of the stride pattern @sp does not wrap in the unsigned sense
+static bool
+HasNoUnsignedWrap(const StridePattern & sp) {
+  if (auto * gep = dyn_cast<GetElementPtrInst>(sp.reductor)) return gep->isInBounds();
+  return sp.reductor->hasNoUnsignedWrap();
+}
+
 class
 BranchCondition { // LoopExitCondition
   bool loopExitOnTrue; // exit taken if \p evaluates to true
@@ -80,6 +99,12 @@ public:
   bool
   exitsOnTrue() const { return loopExitOnTrue; }
 
+  CmpInst &
+  getCmp() const { return cmp; }
+
+  StridePattern &
+  getStridePattern() const { return sp; }
+
   BranchCondition(bool _loopExitOnTrue, bool _exitWhenEqual, llvm::CmpInst & _cmp, CmpInst::Predicate _adjustedPred, int _cmpReductIdx, StridePattern & _sp, int vectorWidth)
   : loopExitOnTrue(_loopExitOnTrue)
   , exitWhenEqual(_exitWhenEqual)
@@ -153,8 +178,8 @@ public:
     bool tmpExitOnTrue = loopExitOnTrue;
 
     // this implicitly assumes that the loop iteration variable I is incremented by a constant C without wrapping
-    const bool nswFlag = sp.reductor->hasNoSignedWrap();
-    const bool nuwFlag = sp.reductor->hasNoUnsignedWrap();
+    const bool nswFlag = HasNoSignedWrap(sp);
+    const bool nuwFlag = HasNoUnsignedWrap(sp);
 
     const auto cmpPred = cmp.getPredicate();
     CmpInst::Predicate adjustedPred = cmpPred;
@@ -258,9 +283,12 @@ public:
 
     // increment the iteration variable as necessary
     Value * adjusted = nullptr;
-    if (offset != 0) {
-      const bool nswFlag = sp.reductor->hasNoSignedWrap();
-      const bool nuwFlag = sp.reductor->hasNoUnsignedWrap();
+    if (offset != 0 && sp.isPointer()) {
+      // pointer inductions are offset in bytes
+      adjusted = &sp.createOffset(builder, val, offset);
+    } else if (offset != 0) {
+      const bool nswFlag = HasNoSignedWrap(sp);
+      const bool nuwFlag = HasNoUnsignedWrap(sp);
       adjusted = builder.CreateAdd(&val, ConstantInt::get(val.getType(), offset), "", nswFlag, nuwFlag);
     } else {
       adjusted = &val;
@@ -301,6 +329,8 @@ struct LoopTransformer {
 
   int vectorWidth;
   int tripAlign;
+  int minTripCount; // minimal number of iterations to enter the vector loop
+  bool foldTail; // the vector loop executes the remainder iterations as a masked vector iteration
 
   // - original loop -
   //
@@ -340,21 +370,21 @@ struct LoopTransformer {
   // exit of the vector loop to the scalar guard
   BasicBlock * vecToScalarExit;
 
+  // exiting blocks other than the latch (data-dependent early exits)
+  SmallVector<BasicBlock*, 2> earlyExitings;
+
+  // the exit block of the latch
   static
   BasicBlock*
-  GetUniqueExiting(llvm::Loop & L) {
-    auto * exitBlock = L.getExitBlock();
-    for (auto & use : exitBlock->uses()) {
-      auto * exitingBr = dyn_cast<BranchInst>(use.getUser());
-      if (!exitingBr) continue;
-      if (!L.contains(exitingBr->getParent())) continue;
-
-      return exitingBr->getParent();
+  GetLatchExit(llvm::Loop & L) {
+    auto * latchTerm = L.getLoopLatch()->getTerminator();
+    for (size_t i = 0; i < latchTerm->getNumSuccessors(); ++i) {
+      if (!L.contains(latchTerm->getSuccessor(i))) return latchTerm->getSuccessor(i);
     }
     return nullptr;
   }
 
-  LoopTransformer(Function & _F, DominatorTree & _DT, PostDominatorTree & _PDT, LoopInfo & _LI, ReductionAnalysis & _reda, std::set<Value*> & _uniOverrides, BranchCondition & _exitBuilder, Loop & _ScalarL, Loop & _ClonedL, ValueToValueMapTy & _vecValMap, int _vectorWidth, int _tripAlign)
+  LoopTransformer(Function & _F, DominatorTree & _DT, PostDominatorTree & _PDT, LoopInfo & _LI, ReductionAnalysis & _reda, std::set<Value*> & _uniOverrides, BranchCondition & _exitBuilder, Loop & _ScalarL, Loop & _ClonedL, ValueToValueMapTy & _vecValMap, int _vectorWidth, int _tripAlign, int _minTripCount, bool _foldTail)
   : F(_F)
   , DT(_DT)
   , PDT(_PDT)
@@ -367,14 +397,21 @@ struct LoopTransformer {
   , uniOverrides(_uniOverrides)
   , vectorWidth(_vectorWidth)
   , tripAlign(_tripAlign)
+  , minTripCount(std::max(_vectorWidth, _minTripCount))
+  , foldTail(_foldTail)
   , entryBlock(ScalarL.getLoopPreheader())
-  , loopExit(ScalarL.getExitBlock())
+  , loopExit(GetLatchExit(ScalarL))
   , vecGuardBlock(nullptr)
   , scalarGuardBlock(nullptr)
   , vecToScalarExit(nullptr)
   {
-    assert(loopExit && "multi exit loops unsupported (yet)");
-    assert(ScalarL.getExitingBlock() && "Scalar loop does not have a unique exiting block (unsupported)");
+    assert(loopExit && "Scalar loop does not exit from its latch (unsupported)");
+
+    SmallVector<BasicBlock*, 4> exitingBlocks;
+    ScalarL.getExitingBlocks(exitingBlocks);
+    for (auto * exiting : exitingBlocks) {
+      if (exiting != ScalarL.getLoopLatch()) earlyExitings.push_back(exiting);
+    }
 
     // create all basic blocks
     setupControl();
@@ -423,7 +460,7 @@ struct LoopTransformer {
     }
 
   // make the vector loop exit to vecToScalar
-    auto * scaExiting = ScalarL.getExitingBlock();
+    auto * scaExiting = ScalarL.getLoopLatch();
     auto * scalarTerm = scaExiting->getTerminator();
     auto * vecLoopExiting = &LookUp(vecValMap, *scalarTerm->getParent());
     auto * vecTerm = cast<Instruction>(vecValMap[scalarTerm]);
@@ -581,7 +618,7 @@ struct LoopTransformer {
     }
 
     // replicate the vector loop exit condition
-    auto & scaExiting = *GetUniqueExiting(ScalarL);
+    auto & scaExiting = *ScalarL.getLoopLatch();
     auto & vecExiting = LookUp(vecValMap, scaExiting);
 
     auto & vecExitingBr = cast<BranchInst>(*vecExiting.getTerminator());
@@ -626,10 +663,183 @@ struct LoopTransformer {
     uniOverrides.insert(&exitVal);
   }
 
+  // replicate the scalar loop exit test for the iteration where the tested iteration variable evaluates to @iterVal
+  // the result is true if the scalar loop executes that iteration (instructions created for it are added to @valueSet)
+  Value&
+  CreateIterationActiveTest(Value & iterVal, std::string suffix, IRBuilder<> & builder, std::set<Value*> * valueSet) {
+    auto & sp = exitConditionBuilder.getStridePattern();
+    auto & scaExitingBr = cast<BranchInst>(*ScalarL.getLoopLatch()->getTerminator());
+
+    ValueToValueMapTy replMap;
+    auto & exitVal =
+      ReplicateExpression(suffix, *scaExitingBr.getCondition(), replMap,
+         [&](Instruction & inst, IRBuilder<> & leafBuilder) -> Value* {
+           // loop invariant value
+           if (!ScalarL.contains(inst.getParent())) return &inst;
+
+           // the exit test of the previous iteration decides whether this iteration runs
+           if (&inst == sp.reductor) return &iterVal;
+           if (&inst == sp.phi) {
+             auto * prevVal = &sp.createOffset(leafBuilder, iterVal, -sp.inc, inst.getName().str() + suffix);
+             if (valueSet && isa<Instruction>(prevVal)) valueSet->insert(prevVal);
+             return prevVal;
+           }
+
+           // Otw, copy that operation
+           return nullptr;
+          },
+      builder
+      );
+
+    if (valueSet) {
+      for (auto itRepl : replMap) {
+        Value * replVal = itRepl.second;
+        if (isa<Instruction>(replVal)) valueSet->insert(replVal);
+      }
+    }
+
+    if (!exitConditionBuilder.exitsOnTrue()) return exitVal;
+
+    auto * stayVal = builder.CreateNot(&exitVal, exitVal.getName().str() + ".stay");
+    if (valueSet) valueSet->insert(stayVal);
+    return *stayVal;
+  }
+
+  // test whether advancing the integer iteration variable @iterVal by @amount does not wrap
+  // in the signedness of the loop exit comparison (nullptr for pointer inductions)
+  Value*
+  CreateNoWrapTest(Value & iterVal, int64_t amount, IRBuilder<> & builder) {
+    auto * intTy = dyn_cast<IntegerType>(iterVal.getType());
+    if (!intTy) return nullptr;
+
+    bool isSigned = exitConditionBuilder.getCmp().isSigned();
+    unsigned bits = intTy->getBitWidth();
+    APInt step(bits, amount, true);
+    bool overflow = false;
+    APInt limit(bits, 0);
+    if (amount >= 0) {
+      // iterVal <= MAX - amount
+      limit = isSigned ? APInt::getSignedMaxValue(bits).ssub_ov(step, overflow) : APInt::getMaxValue(bits).usub_ov(step, overflow);
+    } else {
+      // iterVal >= MIN + |amount|
+      APInt negStep = -step;
+      limit = isSigned ? APInt::getSignedMinValue(bits).sadd_ov(negStep, overflow) : APInt::getMinValue(bits).uadd_ov(negStep, overflow);
+    }
+    // the step itself is not representable
+    if (overflow || (step.getSExtValue() != amount)) return builder.getFalse();
+
+    auto pred = (amount >= 0) ? (isSigned ? CmpInst::ICMP_SLE : CmpInst::ICMP_ULE)
+                              : (isSigned ? CmpInst::ICMP_SGE : CmpInst::ICMP_UGE);
+    return builder.CreateICmp(pred, &iterVal, ConstantInt::get(intTy, limit), iterVal.getName().str() + ".noWrap");
+  }
+
+  // fold the remainder iterations into the vector loop
+  // the body of the vector loop is guarded by the lane-wise scalar loop exit test and the vector loop exits if no lane of its next iteration is active
+  //
+  //  vecHead (phis, iteration variable updates, lane test)
+  //   |    \
+  //  body   |
+  //   |    /
+  //  vecTail (reduction joins, exit test) --> vec2scalar
+  void
+  FoldVectorLoopTail() {
+    auto & sp = exitConditionBuilder.getStridePattern();
+    auto & vecHead = LookUp(vecValMap, *ScalarL.getHeader());
+    auto & vecLatch = LookUp(vecValMap, *ScalarL.getLoopLatch());
+    auto & vecPhi = cast<PHINode>(LookUp(vecValMap, *sp.phi));
+    std::string loopName = ScalarL.getName().str();
+
+    // split off the exiting branch and the loop body
+    auto & vecTail = *SplitBlock(&vecLatch, vecLatch.getTerminator(), &DT, &LI);
+    vecTail.setName(loopName + ".vecTail");
+    auto & bodyLatch = *vecTail.getSinglePredecessor();
+    auto & vecBody = *SplitBlock(&vecHead, vecHead.getFirstNonPHI(), &DT, &LI);
+    vecBody.setName(loopName + ".vecBody");
+
+    // the iteration variables of the next iteration are updated unconditionally in the header
+    for (auto & Inst : *ScalarL.getHeader()) {
+      auto * phi = dyn_cast<PHINode>(&Inst);
+      if (!phi) break;
+      auto * pat = reda.getStrideInfo(*phi);
+      if (!pat) continue;
+      LookUp(vecValMap, *pat->reductor).moveBefore(vecHead.getTerminator());
+    }
+
+    IRBuilder<> builder(vecHead.getTerminator());
+
+    // lane-wise test whether the scalar loop would execute this iteration
+    auto & laneActive = CreateIterationActiveTest(vecPhi, ".lane", builder, nullptr);
+
+    // the vector loop continues if the first lane of its next iteration is active
+    // (and the iteration variable of that iteration is representable, otw no scalar iterations remain)
+    auto * nextIterVal = &sp.createOffset(builder, vecPhi, vectorWidth * sp.inc, vecPhi.getName().str() + ".nextVec");
+    uniOverrides.insert(nextIterVal);
+    Value * exitVal = &CreateIterationActiveTest(*nextIterVal, ".vecExit", builder, &uniOverrides);
+    auto * noWrapVal = CreateNoWrapTest(vecPhi, vectorWidth * sp.inc, builder);
+    if (noWrapVal) {
+      uniOverrides.insert(noWrapVal);
+      exitVal = builder.CreateAnd(noWrapVal, exitVal, "nextVecActive");
+      uniOverrides.insert(exitVal);
+    }
+    if (exitConditionBuilder.exitsOnTrue()) {
+      exitVal = builder.CreateNot(exitVal, "vecExit");
+      uniOverrides.insert(exitVal);
+    }
+    cast<BranchInst>(vecTail.getTerminator())->setCondition(exitVal);
+
+    // skip the body for inactive lanes
+    auto * headTerm = vecHead.getTerminator();
+    BranchInst::Create(&vecBody, &vecTail, &laneActive, headTerm);
+    headTerm->eraseFromParent();
+    DT.changeImmediateDominator(&vecTail, &vecHead);
+
+    // reductions keep their value on inactive lanes
+    IRBuilder<> joinBuilder(&vecTail, vecTail.begin());
+    for (auto & Inst : *ScalarL.getHeader()) {
+      auto * phi = dyn_cast<PHINode>(&Inst);
+      if (!phi) break;
+      if (reda.getStrideInfo(*phi)) continue;
+
+      auto & vecRedPhi = cast<PHINode>(LookUp(vecValMap, *phi));
+      int latchIdx = vecRedPhi.getBasicBlockIndex(&vecTail);
+      assert(latchIdx >= 0);
+      auto * latchVal = vecRedPhi.getIncomingValue(latchIdx);
+
+      auto * joinPhi = joinBuilder.CreatePHI(vecRedPhi.getType(), 2, vecRedPhi.getName().str() + ".join");
+      joinPhi->addIncoming(latchVal, &bodyLatch);
+      joinPhi->addIncoming(&vecRedPhi, &vecHead);
+      vecRedPhi.setIncomingValue(latchIdx, joinPhi);
+
+      // the vector loop live outs (scalar guard, loop exit) see the joined value
+      SmallVector<Use*, 4> outsideUses;
+      for (auto & use : latchVal->uses()) {
+        auto * userInst = cast<Instruction>(use.getUser());
+        if (userInst == joinPhi || ClonedL.contains(userInst->getParent())) continue;
+        outsideUses.push_back(&use);
+      }
+      for (auto * use : outsideUses) use->set(joinPhi);
+    }
+  }
+
   // supplement the vector loop guard condition
-  // the Vloop is executed if there is at least one full vector of iterations
+  // the Vloop is executed if there are at least minTripCount (>= one full vector of) iterations
   void
   SupplementVectorGuard() {
+    // a folded vector loop handles any positive number of iterations.
+    // Its first lane is active if the scalar loop would execute its first iteration after a top test,
+    // an unguarded (do-while) loop that does not pass that test runs its single iteration in the scalar loop.
+    if (foldTail) {
+      auto & vecGuardBr = *cast<BranchInst>(vecGuardBlock->getTerminator());
+      auto & sp = exitConditionBuilder.getStridePattern();
+      auto & vecPhi = cast<PHINode>(LookUp(vecValMap, *sp.phi));
+      auto * initVal = vecPhi.getIncomingValueForBlock(vecGuardBlock);
+
+      IRBuilder<> builder(&vecGuardBr);
+      Value * enterVal = &CreateIterationActiveTest(*initVal, ".vecGuard", builder, nullptr);
+      vecGuardBr.setCondition(exitConditionBuilder.exitsOnTrue() ? builder.CreateNot(enterVal, "vecGuard") : enterVal);
+      return;
+    }
+
     // map vector phis to their shapes
     std::map<Value*, rv::VectorShape> valShapes;
     std::map<Value*, PHINode*> reductors;
@@ -653,7 +863,7 @@ struct LoopTransformer {
 
     // synthesize(int iterOffset, std::string suffix, IRBuilder<> & builder, std::function<Instruction& (Instruction&)> embedFunc) {
     auto & exitVal =
-      exitConditionBuilder.synthesize(vectorWidth, ".vecGuard", builder, nullptr,
+      exitConditionBuilder.synthesize(minTripCount, ".vecGuard", builder, nullptr,
          [&](Instruction & inst) -> IterValue {
            assert (!isa<CallInst>(inst));
 
@@ -698,7 +908,7 @@ struct LoopTransformer {
   // replicate the scalar loop exit condition in vecToScalarExit
   void
   SupplementVectorExit(ValueToValueMapTy & vecLoopPhis) {
-    auto & scaExiting = *GetUniqueExiting(ScalarL);
+    auto & scaExiting = *ScalarL.getLoopLatch();
     auto & vecExiting = LookUp(vecValMap, scaExiting);
 
     auto & exitingBr = cast<BranchInst>(*scaExiting.getTerminator());
@@ -710,7 +920,7 @@ struct LoopTransformer {
 
     auto & vecExitBr = *cast<BranchInst>(vecToScalarExit->getTerminator());
 
-    if (tripAlign % vectorWidth != 0) {
+    if (!foldTail && (tripAlign % vectorWidth != 0)) {
       IF_DEBUG { errs() << "remTrans: need a scalar remainder loop.\n"; }
     // replicate the exit condition
       // replace scalar reductors with their vector-loop versions
@@ -769,14 +979,20 @@ struct LoopTransformer {
 
           if (ScalarL.contains(userInst)) continue;
 
+          // the vector loop only leaves through the latch (early exits are taken by the scalar loop)
+          if (!earlyExitings.empty() && userInst->getParent() != loopExit) continue;
+
           auto scaLiveOut = &Inst;
           auto vecLiveOut = &LookUp(vecValMap, Inst);
 
           if (isa<PHINode>(userInst) && userInst->getParent() == loopExit) {
             auto & userPhi = *cast<PHINode>(userInst);
-            int exitingIdx = userPhi.getBasicBlockIndex(ScalarL.getExitingBlock());
+            int exitingIdx = userPhi.getBasicBlockIndex(ScalarL.getLoopLatch());
             assert(exitingIdx >= 0);
 
+            // value leaves through an early exit that shares the latch exit block
+            if (userPhi.getIncomingBlock(useOperandNo) != ScalarL.getLoopLatch()) continue;
+
             // vector loop is exiting to this block now as well
             userPhi.addIncoming(vecLiveOut, vecToScalarExit);
 
@@ -786,7 +1002,7 @@ struct LoopTransformer {
             if (!mergePhi) {
               std::string liveOutName = scaLiveOut->getName().str();
               mergePhi = exitBuilder.CreatePHI(scaLiveOut->getType(), 2, liveOutName + ".merge");
-              mergePhi->addIncoming(scaLiveOut, ScalarL.getExitingBlock());
+              mergePhi->addIncoming(scaLiveOut, ScalarL.getLoopLatch());
               mergePhi->addIncoming(vecLiveOut, vecToScalarExit);
               IF_DEBUG { errs() << "\tCreated merge phi " << *mergePhi << "\n"; }
             }
@@ -797,6 +1013,102 @@ struct LoopTransformer {
         }
       }
     }
+
+  // exit phis with loop invariant inputs from the latch
+    for (auto & Inst : *loopExit) {
+      auto * exitPhi = dyn_cast<PHINode>(&Inst);
+      if (!exitPhi) break;
+      if (exitPhi->getBasicBlockIndex(vecToScalarExit) >= 0) continue;
+      int latchIdx = exitPhi->getBasicBlockIndex(ScalarL.getLoopLatch());
+      if (latchIdx < 0) continue;
+      exitPhi->addIncoming(exitPhi->getIncomingValue(latchIdx), vecToScalarExit);
+    }
+  }
+
+  // leave the vector loop if any lane takes an early exit.
+  // The scalar loop replays the exiting vector iteration from its start and leaves through the exit of the first exiting lane (with its live outs).
+  // Lanes past the exiting lane are evaluated speculatively (the loop must not have side effects).
+  void
+  SupplementEarlyExits() {
+    if (earlyExitings.empty()) return;
+
+    auto & context = vecToScalarExit->getContext();
+    auto & vecLatch = LookUp(vecValMap, *ScalarL.getLoopLatch());
+    auto & boolTy = *Type::getInt1Ty(context);
+
+  // record whether a lane took an early exit in this iteration
+    SmallVector<BasicBlock*, 4> latchPreds(pred_begin(&vecLatch), pred_end(&vecLatch));
+    auto * earlyExitPhi = PHINode::Create(&boolTy, latchPreds.size() + earlyExitings.size(), "earlyExit", &*vecLatch.begin());
+    for (auto * pred : latchPreds) {
+      earlyExitPhi->addIncoming(ConstantInt::getFalse(context), pred);
+    }
+
+    for (auto * scaExiting : earlyExitings) {
+      auto & vecExiting = LookUp(vecValMap, *scaExiting);
+      auto & exitingBr = cast<BranchInst>(*vecExiting.getTerminator());
+      int exitIdx = ScalarL.contains(scaExiting->getTerminator()->getSuccessor(0)) ? 1 : 0;
+
+      if (exitingBr.getSuccessor(1 - exitIdx) == &vecLatch) {
+        // both edges lead to the latch
+        Value * exitCond = exitingBr.getCondition();
+        if (exitIdx == 1) exitCond = BinaryOperator::CreateNot(exitCond, "earlyExitCond", &exitingBr);
+        earlyExitPhi->setIncomingValueForBlock(&vecExiting, exitCond);
+        BranchInst::Create(&vecLatch, &exitingBr);
+        exitingBr.eraseFromParent();
+        continue;
+      }
+
+      // divert the early exit to the latch
+      exitingBr.setSuccessor(exitIdx, &vecLatch);
+      earlyExitPhi->addIncoming(ConstantInt::getTrue(context), &vecExiting);
+
+      // the exiting vector iteration gets replayed, its latch values are irrelevant
+      for (auto & Inst : vecLatch) {
+        auto * phi = dyn_cast<PHINode>(&Inst);
+        if (!phi) break;
+        if (phi == earlyExitPhi) continue;
+        phi->addIncoming(UndefValue::get(phi->getType()), &vecExiting);
+      }
+    }
+
+  // leave the vector loop if any lane exits early
+    auto & latchBr = cast<BranchInst>(*vecLatch.getTerminator());
+    IRBuilder<> builder(&latchBr);
+    auto & anyFunc = DeclareIntrinsic(RVIntrinsic::Any, *F.getParent());
+    auto * anyExit = builder.CreateCall(&anyFunc, {earlyExitPhi}, "anyEarlyExit");
+
+    Value * latchCond = latchBr.getCondition();
+    if (exitConditionBuilder.exitsOnTrue()) {
+      latchCond = builder.CreateOr(latchCond, anyExit, "vecExit");
+    } else {
+      auto * noExit = builder.CreateNot(anyExit, "noEarlyExit");
+      uniOverrides.insert(noExit);
+      latchCond = builder.CreateAnd(latchCond, noExit, "vecStay");
+    }
+    uniOverrides.insert(latchCond);
+    latchBr.setCondition(latchCond);
+
+  // replay the exiting vector iteration in the scalar loop
+    auto * anyExitOut = PHINode::Create(&boolTy, 1, "anyEarlyExit.lcssa", &*vecToScalarExit->begin());
+    anyExitOut->addIncoming(anyExit, &vecLatch);
+
+    auto & v2sBr = cast<BranchInst>(*vecToScalarExit->getTerminator());
+    IRBuilder<> exitBuilder(&v2sBr);
+    bool scalarOnTrue = v2sBr.getSuccessor(0) == scalarGuardBlock;
+    v2sBr.setCondition(exitBuilder.CreateSelect(anyExitOut, ConstantInt::getBool(context, scalarOnTrue), v2sBr.getCondition()));
+
+    // restart the scalar loop from the first iteration of the exiting vector iteration
+    for (auto & Inst : *ScalarL.getHeader()) {
+      auto * phi = dyn_cast<PHINode>(&Inst);
+      if (!phi) break;
+      auto & pat = *reda.getStrideInfo(*phi);
+
+      auto & scaGuardPhi = cast<PHINode>(*phi->getIncomingValueForBlock(scalarGuardBlock));
+      int v2sIdx = scaGuardPhi.getBasicBlockIndex(vecToScalarExit);
+      auto * nextVal = scaGuardPhi.getIncomingValue(v2sIdx);
+      auto * replayVal = &pat.createOffset(exitBuilder, *nextVal, -vectorWidth * pat.inc, phi->getName().str() + ".replay");
+      scaGuardPhi.setIncomingValue(v2sIdx, exitBuilder.CreateSelect(anyExitOut, replayVal, nextVal));
+    }
   }
 
   void
@@ -831,7 +1143,15 @@ struct LoopTransformer {
     SupplementVectorExit(vecLoopPhis);
 
     // repair the vector loop exit condition to check for the next iteration (instead on the phi + strie * vectorWidth -th)
-    RepairVectorLoopCondition(vecLoopPhis);
+    // (or mask the lanes past the trip count when folding the tail)
+    if (foldTail) {
+      FoldVectorLoopTail();
+    } else {
+      RepairVectorLoopCondition(vecLoopPhis);
+    }
+
+    // leave to the scalar loop if any lane takes an early exit
+    SupplementEarlyExits();
 
   // supplement the vector loop guard condition (vecGuardBlock -> vector loop edge)
     // the vector loop will execute on at least one full vector
@@ -841,7 +1161,7 @@ struct LoopTransformer {
 
 BranchCondition*
 RemainderTransform::analyzeExitCondition(llvm::Loop & L, int vectorWidth) {
-  auto * loopExiting = L.getExitingBlock();
+  auto * loopExiting = L.getLoopLatch();
 
 
   // loop exit conditions constraints
@@ -856,23 +1176,20 @@ RemainderTransform::analyzeExitCondition(llvm::Loop & L, int vectorWidth) {
 
 bool
 RemainderTransform::canTransformLoop(llvm::Loop & L) {
-  auto * loopExiting = L.getExitingBlock();
-  if (!loopExiting) {
-    Report() << "remTrans: multi-exit loops not supported yet\n";
-    return false;
-  }
-
   auto * loopLatch = L.getLoopLatch();
   if (!loopLatch) {
     Report() << "remTrans: multi-latch loops not supported yet\n";
     return false;
   }
 
-  if (loopLatch != L.getExitingBlock()) {
+  if (!L.isLoopExiting(loopLatch)) {
     Report() << "remTrans: only support latch exit loops\n";
     return false;
   }
 
+  // the scalar loop replays vector iterations that take an early exit
+  if (!L.getExitingBlock() && !canReplayEarlyExits(L)) return false;
+
   if (!L.getLoopPreheader()) {
     Report() << "remTrans: require a unique pre-header\n";
     return false;
@@ -893,8 +1210,124 @@ RemainderTransform::canTransformLoop(llvm::Loop & L) {
   return true;
 }
 
+bool
+RemainderTransform::canReplayEarlyExits(llvm::Loop & L) {
+  if (!L.isLCSSAForm(DT)) {
+    Report() << "remTrans: early exit loops must be in LCSSA form\n";
+    return false;
+  }
+
+  SmallVector<BasicBlock*, 4> exitingBlocks;
+  L.getExitingBlocks(exitingBlocks);
+  for (auto * exiting : exitingBlocks) {
+    auto * exitingBr = dyn_cast<BranchInst>(exiting->getTerminator());
+    if (!exitingBr || !exitingBr->isConditional()) {
+      Report() << "remTrans: unsupported early exit " << *exiting->getTerminator() << "\n";
+      return false;
+    }
+  }
+
+  // lanes past the exiting lane execute speculatively and get replayed in the scalar loop
+  for (auto * BB : L.blocks()) {
+    for (auto & Inst : *BB) {
+      if (Inst.mayHaveSideEffects()) {
+        Report() << "remTrans: can not replay early exit loop with side effect " << Inst << "\n";
+        return false;
+      }
+      // speculative lanes must not fault or trap (eg divisions, loads past the end of an array)
+      if (isa<PHINode>(Inst) || Inst.isTerminator() || isSafeToSpeculativelyExecute(&Inst)) continue;
+      auto * load = dyn_cast<LoadInst>(&Inst);
+      if (load && SE && isDereferenceableAndAlignedInLoop(load, &L, *SE, DT)) continue;
+      Report() << "remTrans: can not speculate past an early exit: " << Inst << "\n";
+      return false;
+    }
+  }
+
+  // the replayed iteration starts from the inductions of the exiting vector iteration
+  for (auto & Inst : *L.getHeader()) {
+    auto * phi = dyn_cast<PHINode>(&Inst);
+    if (!phi) break;
+    if (!reda.getStrideInfo(*phi)) {
+      Report() << "remTrans: can not replay early exit loop with recurrence " << *phi << "\n";
+      return false;
+    }
+  }
+
+  return true;
+}
+
+bool
+RemainderTransform::canFoldTail(llvm::Loop & L, BranchCondition & branchCond) {
+  if (!L.getExitingBlock()) {
+    Report() << "remTrans: can not fold the tail of a loop with early exits\n";
+    return false;
+  }
+
+  // the lanes of the folded iteration must be active up to the last scalar iteration
+  if (branchCond.getCmp().isEquality()) {
+    Report() << "remTrans: can not fold the tail of a loop with an equality exit test\n";
+    return false;
+  }
+
+  // only the final values of reductions may leave the loop
+  std::set<Value*> reductionLiveOuts;
+  for (auto & Inst : *L.getHeader()) {
+    auto * phi = dyn_cast<PHINode>(&Inst);
+    if (!phi) break;
+    if (reda.getStrideInfo(*phi)) continue;
+    reductionLiveOuts.insert(phi->getIncomingValueForBlock(L.getLoopLatch()));
+  }
+
+  for (auto * BB : L.blocks()) {
+    for (auto & Inst : *BB) {
+      if (reductionLiveOuts.count(&Inst)) continue;
+      for (auto * user : Inst.users()) {
+        auto * userInst = cast<Instruction>(user);
+        if (L.contains(userInst->getParent())) continue;
+        Report() << "remTrans: can not fold the tail of a loop with live out " << Inst << "\n";
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+void
+RemainderTransform::collectDereferenceableAccesses(Loop & L, int vectorWidth, ValueSet & derefAccesses) {
+  if (!SE) return;
+  unsigned maxTripCount = SE->getSmallConstantMaxTripCount(&L);
+  if (maxTripCount == 0) return;
+
+  const auto & DL = F.getParent()->getDataLayout();
+  uint64_t numVectorIters = (maxTripCount + vectorWidth - 1) / vectorWidth;
+  for (auto * BB : L.blocks()) {
+    for (auto & Inst : *BB) {
+      auto * ptr = getLoadStorePointerOperand(&Inst);
+      if (!ptr) continue;
+      auto * accessTy = isa<StoreInst>(Inst) ? cast<StoreInst>(Inst).getValueOperand()->getType() : Inst.getType();
+      uint64_t byteSize = DL.getTypeStoreSize(accessTy);
+
+      // the address recurrence walks the underlying object in steps of the access size
+      auto * addRec = dyn_cast<SCEVAddRecExpr>(SE->getSCEV(ptr));
+      if (!addRec || !addRec->isAffine() || addRec->getLoop() != &L) continue;
+      auto * step = dyn_cast<SCEVConstant>(addRec->getStepRecurrence(*SE));
+      auto * base = dyn_cast<SCEVUnknown>(SE->getPointerBase(addRec));
+      if (!step || !base || step->getAPInt() != byteSize) continue;
+      auto * startOffset = dyn_cast<SCEVConstant>(SE->getMinusSCEV(addRec->getStart(), base));
+      if (!startOffset || startOffset->getAPInt().isNegative()) continue;
+
+      bool canBeNull = false;
+      uint64_t objectSize = base->getValue()->getPointerDereferenceableBytes(DL, canBeNull);
+      uint64_t endOffset = startOffset->getAPInt().getZExtValue() + numVectorIters * vectorWidth * byteSize;
+      if (canBeNull || endOffset > objectSize) continue;
+      derefAccesses.insert(ptr);
+    }
+  }
+}
+
 Loop*
-RemainderTransform::createVectorizableLoop(Loop & L, ValueSet & uniOverrides, int vectorWidth, int tripAlign) {
+RemainderTransform::createVectorizableLoop(Loop & L, ValueSet & uniOverrides, ValueSet & derefAccesses, int vectorWidth, int tripAlign, int minTripCount, bool foldTail) {
 // run capability checks
   // CFG caps
   if (!canTransformLoop(L)) return nullptr;
@@ -914,9 +1347,21 @@ RemainderTransform::createVectorizableLoop(Loop & L, ValueSet & uniOverrides, in
     return nullptr;
   }
 
+  if (foldTail && !canFoldTail(L, *branchCond)) {
+    Report() << "remTrans: falling back to a scalar remainder loop\n";
+    foldTail = false;
+  }
+
+  // SCEV still describes the trip count of the scalar loop at this point (the vector loop gets a new exit condition)
+  ValueSet scalarDerefAccesses;
+  collectDereferenceableAccesses(L, vectorWidth, scalarDerefAccesses);
+
 // otw, clone the scalar loop
   ValueToValueMapTy cloneMap;
   auto cloneInfo = CloneLoop(L, F, DT, PDT, LI, PB, cloneMap);
+  for (auto * ptr : scalarDerefAccesses) {
+    derefAccesses.insert(cloneMap[ptr]);
+  }
 #if 0
   LoopCloner loopCloner(F, DT, PDT, LI, PB);
   ValueToValueMapTy cloneMap;
@@ -927,7 +1372,7 @@ RemainderTransform::createVectorizableLoop(Loop & L, ValueSet & uniOverrides, in
   // reda.updateForClones(LI, cloneMap);
 
 // embed the cloned loop
-  LoopTransformer loopTrans(F, DT, PDT, LI, reda, uniOverrides, *branchCond, L, clonedLoop, cloneMap, vectorWidth, tripAlign);
+  LoopTransformer loopTrans(F, DT, PDT, LI, reda, uniOverrides, *branchCond, L, clonedLoop, cloneMap, vectorWidth, tripAlign, minTripCount, foldTail);
 
   // rebuild reduction information for cloned loop
   reda.analyze(clonedLoop);
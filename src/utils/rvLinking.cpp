@@ -7,6 +7,8 @@
 #include <llvm/IR/InstIterator.h>
 #include <llvm/Transforms/Utils/ValueMapper.h>
 #include <llvm/Transforms/Utils/Cloning.h>
+#include <llvm/Support/Error.h>
+#include <llvm/Support/raw_ostream.h>
 
 using namespace llvm;
 
@@ -73,6 +75,14 @@ Function &cloneFunctionIntoModule(Function &func, Module &cloneInto, StringRef n
     return *existingFn;
   }
 
+  // functions of lazily loaded modules (eg SLEEF) are materialized on first use
+  if (func.isMaterializable()) {
+    if (Error err = func.materialize()) {
+      logAllUnhandledErrors(std::move(err), errs(), "rv::cloneFunctionIntoModule: ");
+      abort();
+    }
+  }
+
   // create function in new module, create the argument mapping, clone function into new function body, return
   Function & clonedFn = *Function::Create(func.getFunctionType(), Function::LinkageTypes::ExternalLinkage,
                                         name, &cloneInto);
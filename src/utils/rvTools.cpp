@@ -25,6 +25,7 @@
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Value.h>
 
+#include <llvm/Bitcode/BitcodeReader.h>
 #include <llvm/IRReader/IRReader.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/MemoryBuffer.h> // MemoryBuffer
@@ -148,6 +149,19 @@ Module *createModuleFromBuffer(const char buffer[], size_t length,
   return modPtr.release();
 }
 
+Module *createLazyModuleFromBuffer(const char buffer[], size_t length,
+                                   LLVMContext &context) {
+  MemoryBufferRef mbRef(StringRef(buffer, length), "");
+  Expected<std::unique_ptr<Module>> modOrErr =
+      getLazyBitcodeModule(mbRef, context);
+  if (!modOrErr) {
+    logAllUnhandledErrors(modOrErr.takeError(), errs(),
+                          "rv::createLazyModuleFromBuffer: ");
+    return nullptr;
+  }
+  return modOrErr->release();
+}
+
 Module *createModuleFromFile(const std::string &fileName,
                              LLVMContext &context) {
   SMDiagnostic smDiag;
@@ -69,6 +69,11 @@ createModuleFromFile(const std::string & fileName, LLVMContext & context);
 Module*
 createModuleFromBuffer(const char buffer[], size_t length, LLVMContext & context);
 
+// only reads the module-level symbols of the bitcode in @buffer. Function bodies are materialized on demand.
+// @buffer must outlive the module.
+Module*
+createLazyModuleFromBuffer(const char buffer[], size_t length, LLVMContext & context);
+
 void
 writeModuleToFile(const Module& mod, const std::string& fileName);
 
@@ -281,6 +281,30 @@ VectorizationInfo::removeVaryingPredicateFlag(const llvm::BasicBlock & BB) {
   VaryingPredicateBlocks.erase(&BB);
 }
 
+// lane density estimates
+double
+VectorizationInfo::getLaneDensity(const llvm::BasicBlock & BB) const {
+  auto it = LaneDensities.find(&BB);
+  if (it == LaneDensities.end()) return 1.0;
+  return it->second;
+}
+
+void
+VectorizationInfo::setLaneDensity(const llvm::BasicBlock & BB, double density) {
+  LaneDensities[&BB] = density;
+}
+
+// dereferenceable vector accesses
+bool
+VectorizationInfo::isDereferenceableAccess(const llvm::Value & ptr) const {
+  return DereferenceableAccesses.count(&ptr);
+}
+
+void
+VectorizationInfo::addDereferenceableAccess(const llvm::Value & ptr) {
+  DereferenceableAccesses.insert(&ptr);
+}
+
 // predicate handling
 void VectorizationInfo::dropPredicate(const BasicBlock &block) {
   auto it = predicates.find(&block);
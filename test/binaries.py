@@ -63,7 +63,7 @@ def primaryName(fileName):
 
 def rvToolOuterLoop(scalarLL, destFile, scalarName = "foo", options = {}, logPrefix=None):
     baseName = primaryName(scalarLL)
-    cmd = rvToolLine + " -loopvec -i " + scalarLL
+    cmd = rvToolLine + (" -loopvec-pass" if options['loopPass'] else " -loopvec") + " -i " + scalarLL
     if destFile:
       cmd = cmd + " -o " + destFile
     if scalarName:
@@ -72,12 +72,16 @@ def rvToolOuterLoop(scalarLL, destFile, scalarName = "foo", options = {}, logPre
       cmd = cmd + " -l " + options['loopHint']
     if options['width']:
       cmd = cmd + " -w " + str(options['width'])
+    if options['interleave']:
+      cmd = cmd + " -ic " + str(options['interleave'])
     if options["ulp_math_prec"]:
       cmd += " --math-prec {}".format(options["ulp_math_prec"])
+    if options['vecLib']:
+      cmd += " -veclib " + options['vecLib']
     if 0 < len(options['extraShapes'].items()):
       cmd = cmd + " -x " + ",".join("{}={}".format(k,v) for k,v in options['extraShapes'].items())
 
-    return shellCmd(cmd,  None, logPrefix)
+    return shellCmd(cmd,  options['env'], logPrefix)
 
 def rvToolWFV(scalarLL, destFile, scalarName = "foo", options = {}, logPrefix=None):
     cmd = rvToolLine + " -wfv -lower -i " + scalarLL
@@ -91,12 +95,14 @@ def rvToolWFV(scalarLL, destFile, scalarName = "foo", options = {}, logPrefix=No
       cmd = cmd + " -w " + str(options['width'])
     if options["ulp_math_prec"]:
       cmd += " --math-prec {}".format(options["ulp_math_prec"])
+    if options['vecLib']:
+      cmd += " -veclib " + options['vecLib']
     if 0 < len(options['extraShapes'].items()):
       cmd = cmd + " -x " + ",".join("{}={}".format(k,v) for k,v in options['extraShapes'].items())
 
     cmd += " --math-prec {}".format(testULPBound)
 
-    return shellCmd(cmd,  None, logPrefix)
+    return shellCmd(cmd,  options['env'], logPrefix)
 
 
 
@@ -0,0 +1,46 @@
+#include <stdio.h>
+#include <iostream>
+
+#include <cassert>
+
+#include "launcherTools.h"
+
+extern "C" int foo(int * A, int * B, int n);
+
+// run foo on disjoint and on overlapping arrays (forward and backward dependences)
+int main(int argc, char ** argv) {
+  srand(42);
+
+  const uint maxN = 8 * 100 + 7;
+  const uint numElems = maxN + 8;
+
+  int * A = new int[numElems];
+  int * B = new int[numElems];
+
+  size_t hash = 0;
+  for (uint n = 0; n <= maxN; n += (n < 40 ? 1 : 97)) {
+    for (int dist = -3; dist <= 3; ++dist) {
+      for (uint i = 0; i < numElems; ++i) {
+        A[i] = (rand() % 1000) - 500;
+        B[i] = (rand() % 1000) - 500;
+      }
+
+      // dist == 0 stands for disjoint arrays
+      int r;
+      if (dist == 0) r = foo(A, B, n);
+      else if (dist > 0) r = foo(A + dist, A, n);
+      else r = foo(A, A - dist, n);
+
+      hash = hashArray(A, numElems, hash);
+      hash = hashArray(B, numElems, hash);
+      hash = (101 * hash) ^ (size_t) r;
+    }
+  }
+
+  delete [] A;
+  delete [] B;
+
+  std::cerr << hash << "\n";
+
+  return 0;
+}
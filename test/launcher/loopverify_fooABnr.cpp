@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <iostream>
+
+#include <cassert>
+
+#include "launcherTools.h"
+
+extern "C" int foo(int * A, int * B, int n);
+
+// run foo for all trip counts below the vector width, with partial remainders and for long loops
+static bool
+nextTripCount(uint & n) {
+  if (n < 40) { ++n; return true; }
+  if (n < 8 * 100) { n = 8 * 100; return true; }
+  if (n < 8 * 100 + 7) { n = 8 * 100 + 7; return true; }
+  return false;
+}
+
+int main(int argc, char ** argv) {
+  srand(42);
+
+  const uint maxN = 8 * 100 + 7;
+
+  int * A = new int[maxN];
+  int * B = new int[maxN];
+
+  size_t hash = 0;
+  uint n = 0;
+  do {
+    // small values (no overflows in reductions)
+    for (uint i = 0; i < maxN; ++i) {
+      A[i] = (rand() % 1000) - 500;
+      B[i] = (rand() % 1000) - 500;
+    }
+
+    int r = foo(A, B, n);
+
+    hash = hashArray(A, maxN, hash);
+    hash = hashArray(B, maxN, hash);
+    hash = (101 * hash) ^ (size_t) r;
+  } while (nextTripCount(n));
+
+  delete [] A;
+  delete [] B;
+
+  std::cerr << hash << "\n";
+
+  return 0;
+}
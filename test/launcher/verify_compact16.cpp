@@ -0,0 +1,61 @@
+#include <stdlib.h>
+#include <stdio.h>
+#include <iostream>
+
+#include <cassert>
+
+#include "launcherTools.h"
+
+// 16 lanes of 16 bit data (compacted in chunks of 8 lanes)
+typedef __attribute__((ext_vector_type(16))) short short16;
+
+extern "C" short16 foo_SIMD(short16 a, short16 b);
+
+int main(int argc, char ** argv) {
+  const uint vectorWidth = 16;
+  const uint numVectors = 200;
+
+  for (unsigned i = 0; i < numVectors; ++i) {
+    short a[16];
+    short b[16];
+    for (uint i = 0; i < vectorWidth; ++i) {
+      a[i] = (short) i;
+      b[i] = rand() % 5;
+    }
+
+    short16 res = foo_SIMD(*((short16*) &a), *((short16*) &b));
+
+    short exp[16];
+    for (uint i = 0, j = 0; i < vectorWidth; ++i) {
+      exp[i] = a[i];
+      if (b[i] != 0)
+        exp[j++] = a[i];
+    }
+    short resArray[16];
+    for (uint i = 0; i < vectorWidth; ++i) resArray[i] = res[i];
+
+    bool broken = false;
+    for (uint i = 0; i < vectorWidth; ++i) {
+      if (exp[i] != resArray[i]) {
+        std::cerr << "MISMATCH!\n";
+        broken = true;
+        break;
+      }
+    }
+    if (broken) {
+      std::cerr << "-- vectors --\n";
+      dumpArray(a, vectorWidth); std::cerr << "\n";
+      dumpArray(b, vectorWidth); std::cerr << "\n";
+
+      std::cerr << "-- result --\n";
+      dumpArray(resArray, vectorWidth);
+      std::cerr << "\n";
+
+      std::cerr << "-- expected --\n";
+      dumpArray(exp, vectorWidth);
+      return -1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,10 @@
+// Shapes: T_TrT, LaunchCode: expand
+//
+
+extern "C" float rv_expand(float, bool);
+
+extern "C" float
+foo(float a, int b)
+{
+    return rv_expand(a, b != 0);
+}
@@ -0,0 +1,23 @@
+// Shapes: U_TrT, LaunchCode: sleef
+#include <cmath>
+
+extern "C" float
+foo(int u, float t) {
+  // fused sin/cos pair
+  float r = sinf(t) * cosf(t);
+
+  // out-parameters under a varying predicate
+  float s = 0.0f, c = 0.0f;
+  if (t > 0.5f) {
+    sincosf(t + u, &s, &c);
+  }
+  r += s - c;
+
+  float intPart;
+  float fracPart = modff(t * (u + 1), &intPart);
+  r += fracPart + intPart;
+
+  int e;
+  float m = frexpf(t + 1.0f, &e);
+  return r + m * e;
+}
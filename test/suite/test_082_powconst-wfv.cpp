@@ -0,0 +1,19 @@
+// Shapes: U_TrT, LaunchCode: sleef
+#include <cmath>
+
+extern "C" float
+foo(int u, float t) {
+  // multiplication chain (x^2 is the only chain within 1 ULP)
+  float r = powf(t, 2.0f);
+
+  // too imprecise for a chain at the default bound: stays a pow call
+  r += powf(t + u, 3.0f);
+
+  // trivial exponents
+  r += powf(t, 1.0f) + powf(t, 0.0f) + powf(t + 1.0f, -1.0f);
+
+  // uniform non-constant operands: stay pow calls
+  r += powf(t, (float) (u % 4)) + powf(u % 3 + 1.0f, t);
+
+  return r + powf(t, 7.0f);
+}
@@ -0,0 +1,13 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_TAIL_FOLD=1
+
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i < n; ++i) {
+    if (B[i] > 0) {
+      A[i] = A[i] + B[i];
+    }
+    a += A[i];
+  }
+  return a;
+}
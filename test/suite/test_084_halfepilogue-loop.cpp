@@ -0,0 +1,11 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_HALF_EPILOGUE=1
+
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i < n; ++i) {
+    A[i] = A[i] * B[i];
+    a += B[i];
+  }
+  return a;
+}
@@ -0,0 +1,12 @@
+// LaunchCode: alias, Pass: loopvec, Env: RV_AUTO_VECTORIZE=1
+
+// no vectorization annotation: the loop vectorizer has to check for overlapping arrays at runtime
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i < n; ++i) {
+    A[i] = B[i] * 3 + 1;
+    a += B[i];
+  }
+  return a;
+}
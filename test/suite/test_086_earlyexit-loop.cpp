@@ -0,0 +1,18 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_EARLY_EXIT=1
+
+// data-dependent exit: lanes past the exiting lane load speculatively, which is safe within the table
+int Table[1024];
+
+extern "C" int
+foo(int * A, int * B, int n) {
+  // plant the key at two trip-count dependent positions
+  int key = B[0];
+  Table[(3 * n) % 1024] = key;
+  Table[(5 * n + 7) % 1024] = key;
+
+  int i;
+  for (i = 0; i < 1000; ++i) {
+    if (Table[i] == key) break;
+  }
+  return i;
+}
@@ -0,0 +1,12 @@
+// LaunchCode: fooABnr, Pass: loopvec
+
+// inclusive prefix sum
+extern "C" int
+foo(int * A, int * B, int n) {
+  int s = 0;
+  for (int i = 0; i < n; ++i) {
+    s += A[i];
+    B[i] = s;
+  }
+  return s;
+}
@@ -0,0 +1,13 @@
+// LaunchCode: fooABnr, Pass: loopvec
+
+// exclusive prefix sum (the running value is stored before the element is added)
+extern "C" int
+foo(int * A, int * B, int n) {
+  int s = 0;
+  for (int i = 0; i < n; ++i) {
+    int x = A[i];
+    B[i] = s;
+    s += x;
+  }
+  return s;
+}
@@ -0,0 +1,13 @@
+// LaunchCode: foofABnr, Pass: loopvec
+#include <cmath>
+
+extern "C" float
+foo(float * A, float * B, int n) {
+  float lo = 1000.0f;
+  float hi = -1000.0f;
+  for (int i = 0; i < n; ++i) {
+    lo = fminf(lo, A[i]);
+    hi = fmaxf(hi, B[i]);
+  }
+  return hi - lo;
+}
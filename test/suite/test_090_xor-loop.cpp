@@ -0,0 +1,10 @@
+// LaunchCode: fooABnr, Pass: loopvec
+
+extern "C" int
+foo(int * A, int * B, int n) {
+  int checksum = 0;
+  for (int i = 0; i < n; ++i) {
+    checksum ^= A[i] * 31 + B[i];
+  }
+  return checksum;
+}
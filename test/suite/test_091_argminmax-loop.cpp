@@ -0,0 +1,21 @@
+// LaunchCode: fooABnr, Pass: loopvec
+
+// index of the first minimum (maximum) element, the arrays contain duplicates
+extern "C" int
+foo(int * A, int * B, int n) {
+  int minVal = 1 << 30;
+  int minIdx = -1;
+  int maxVal = -(1 << 30);
+  int maxIdx = -1;
+  for (int i = 0; i < n; ++i) {
+    if (A[i] < minVal) {
+      minVal = A[i];
+      minIdx = i;
+    }
+    if (B[i] > maxVal) {
+      maxVal = B[i];
+      maxIdx = i;
+    }
+  }
+  return minIdx * 1000 + maxIdx;
+}
@@ -0,0 +1,13 @@
+// LaunchCode: fooABnr, Pass: loopvec
+
+// histogram update with colliding lanes under a partial mask
+extern "C" int
+foo(int * A, int * B, int n) {
+  for (int i = 0; i < n; ++i) {
+    int key = A[i] & 15;
+    if (A[i] % 3 != 0) {
+      B[key] += A[i];
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,22 @@
+// LaunchCode: fooABnr, Pass: loopvec
+
+extern "C" int
+foo(int * A, int * B, int n) {
+  int sum = 0;
+  for (int i = 0; i < n; ++i) {
+    // uniform address: one atomic per vector, the lanes observe the values of an in-order execution
+    sum += __atomic_fetch_add(&B[0], A[i], __ATOMIC_RELAXED);
+
+    // under a partial mask (guarded by any active lane)
+    if (A[i] > 0) {
+      __atomic_fetch_or(&B[1], A[i], __ATOMIC_RELAXED);
+    }
+
+    // varying address that is often uniform at runtime
+    sum += __atomic_fetch_add(&B[2 + (A[i] > 400)], i, __ATOMIC_RELAXED);
+
+    // volatile atomics stay per lane
+    __atomic_fetch_add((volatile int *) &B[4], 1, __ATOMIC_RELAXED);
+  }
+  return sum;
+}
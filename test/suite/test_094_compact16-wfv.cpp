@@ -0,0 +1,10 @@
+// Shapes: T_TrT, Width: 16, LaunchCode: compact16
+//
+
+extern "C" short rv_compact(short, bool);
+
+extern "C" short
+foo(short a, short b)
+{
+    return rv_compact(a, b != 0);
+}
@@ -0,0 +1,10 @@
+// Shapes: T_TrT, Width: 16, LaunchCode: expand16
+//
+
+extern "C" short rv_expand(short, bool);
+
+extern "C" short
+foo(short a, short b)
+{
+    return rv_expand(a, b != 0);
+}
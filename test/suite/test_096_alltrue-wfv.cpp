@@ -0,0 +1,29 @@
+// Shapes: T_TrT, LaunchCode: foo2f8
+#include <cmath>
+
+extern "C" bool rv_all(bool);
+
+extern "C" float
+foo(float a, float b)
+{
+  // complementary join: all lanes are active again after the if-else
+  float r;
+  if (a > b) {
+    r = a - b;
+  } else {
+    r = b - a;
+  }
+
+  // always taken: the guarded block runs with a full mask
+  if (rv_all(r >= 0.0f)) {
+    r = sqrtf(r) + fabs(a);
+  }
+
+  // taken by some vectors only (both branches compute the same value to match the scalar reference)
+  if (rv_all(a > b)) {
+    r = r * 2.0f;
+  } else {
+    r = r + r;
+  }
+  return r;
+}
@@ -0,0 +1,18 @@
+// LaunchCode: fooABnr, Pass: loopvec
+
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i < n; ++i) {
+    // complementary join: the store, divisions and reduction below run on all lanes of the vector body
+    int t;
+    if (A[i] > B[i]) {
+      t = A[i] - B[i];
+    } else {
+      t = B[i] - A[i];
+    }
+    B[i] = t;
+    a += t / 3 + A[i] % 7;
+  }
+  return a;
+}
@@ -0,0 +1,14 @@
+// Shapes: U_TrT, LaunchCode: sleef, CFlags: -ffast-math -fno-finite-math-only
+#include <cmath>
+
+extern "C" float
+foo(int u, float t) {
+  // afn, non-integer constant exponent: exp2(k * log2(x))
+  float r = powf(t + 1.0f, 1.3f);
+
+  // afn, positive constant base: exp2(y * log2(c))
+  r += powf(1.7f, t + u % 3);
+
+  // afn, integer exponent: multiplication chain regardless of its rounding error
+  return r + powf(t, 3.0f);
+}
@@ -0,0 +1,12 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_AUTO_VECTORIZE=1
+
+// dependence distance of 4 iterations: the requested vector width (8) has to be clamped
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 4; i < n; ++i) {
+    A[i] = A[i - 4] + B[i];
+    a += B[i];
+  }
+  return a;
+}
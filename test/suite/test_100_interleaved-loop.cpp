@@ -0,0 +1,17 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_INTERLEAVED=1
+
+// xyz triples: interleaved loads and stores of stride 3
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i < n / 3; ++i) {
+    int x = A[3 * i];
+    int y = A[3 * i + 1];
+    int z = A[3 * i + 2];
+    B[3 * i] = y + z;
+    B[3 * i + 1] = x - z;
+    B[3 * i + 2] = 2 * x;
+    a += x + y + z;
+  }
+  return a;
+}
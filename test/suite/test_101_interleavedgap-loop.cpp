@@ -0,0 +1,18 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_INTERLEAVED=1
+
+// stride 4 groups with a gap (member 2 is never accessed) and a conditional member
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i < n / 4; ++i) {
+    int x = A[4 * i];
+    int y = A[4 * i + 1];
+    int w = 0;
+    if (x > y) w = A[4 * i + 3];
+    B[4 * i] = x + w;
+    B[4 * i + 1] = y - w;
+    B[4 * i + 3] = x;
+    a += w;
+  }
+  return a;
+}
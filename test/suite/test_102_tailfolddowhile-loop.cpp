@@ -0,0 +1,14 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_TAIL_FOLD=1
+
+// unguarded loop: the first iteration runs even if n <= 0
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  int i = 0;
+  do {
+    B[i] = A[i] + 1;
+    a += A[i];
+    ++i;
+  } while (i < n);
+  return a;
+}
@@ -0,0 +1,14 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_TAIL_FOLD=1
+#include <climits>
+
+// the iteration variable ends next to INT_MAX (the next vector iteration is not representable)
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  const int start = INT_MAX - n;
+  for (int i = start; i < INT_MAX; ++i) {
+    B[i - start] = A[i - start] * 3;
+    a += A[i - start];
+  }
+  return a;
+}
@@ -0,0 +1,9 @@
+// Shapes: U_TrT, LaunchCode: sleef, VecLib: SVML, Env: RV_PREFER_VECLIB=1
+#include <cmath>
+
+// the vector library (4 ULP) is too imprecise for these call sites (1 ULP), SLEEF has to vectorize them
+// (the test binary does not link SVML)
+extern "C" float
+foo(int u, float t) {
+  return sinf(t) + expf(t * u) + logf(t + 1.0f);
+}
@@ -0,0 +1,13 @@
+// LaunchCode: fooABnr, Pass: loopvec, Width: 4, Interleave: 2
+
+// fixed vector width with an interleave count: two accumulators of width 4 per loop trip
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  int b = 1;
+  for (int i = 0; i < n; ++i) {
+    a += A[i] * B[i];
+    b ^= A[i] + i;
+  }
+  return a + b;
+}
@@ -0,0 +1,15 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_DISABLE_GATHER=1
+
+// masked indirect loads and stores without gather/scatter intrinsics: inactive lanes access a scratch slot
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i < n; ++i) {
+    if (A[i] > 0) {
+      a += A[(A[i] * 7) % n];
+      int j = i ^ 1;
+      if (j < n) B[j] = A[i] + i;
+    }
+  }
+  return a;
+}
@@ -0,0 +1,18 @@
+// LaunchCode: foodAB, Width: 2
+#include <cmath>
+
+extern "C" void
+foo(double * A, double * B, int n) {
+  for (int i = 0; i < n; ++i) {
+    // double precision frexp: the exponents come back in a 128-bit integer vector at width 2
+    int e;
+    double m = frexp(A[i] * 1000.0, &e);
+
+    if (A[i] > 0.5) {
+      // contiguous out-parameter (masked store)
+      A[i] = modf(A[i] * 100.0, &B[i]);
+    } else {
+      B[i] = m * e;
+    }
+  }
+}
@@ -0,0 +1,18 @@
+// Shapes: U_TrT, LaunchCode: sleef
+#include <cmath>
+
+extern "C" float
+foo(int u, float t) {
+  float s = sinf(t);
+  float c = cosf(t);
+  // its partner is already fused with the first sinf call
+  float s2 = sinf(t);
+
+  // two cosf calls compete for one sinf call
+  float x = t * (u + 1);
+  float c1 = cosf(x);
+  float s1 = sinf(x);
+  float c2 = cosf(x);
+
+  return s * c + s2 + c1 * s1 - c2;
+}
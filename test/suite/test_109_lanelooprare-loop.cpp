@@ -0,0 +1,20 @@
+// LaunchCode: fooABnr, Pass: loopvec
+
+__attribute__((noinline)) static int
+rare(int x, int * log) {
+  *log += x;
+  return x * x - 3;
+}
+
+// rarely taken branch (branch weights of __builtin_expect): the call is replicated in a loop over the active lanes
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i < n; ++i) {
+    if (__builtin_expect(A[i] > 490, 0)) {
+      B[i] = rare(A[i], &A[0]);
+    }
+    a += B[i];
+  }
+  return a;
+}
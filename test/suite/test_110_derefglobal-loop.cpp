@@ -0,0 +1,25 @@
+// LaunchCode: fooABnr, Pass: loopvec, Width: 8, Env: RV_TAIL_FOLD=1
+
+static int Table[1024];
+
+__attribute__((noinline)) static void
+fillTable() {
+  for (int i = 0; i < 1024; ++i) {
+    Table[i] = (i * 37) % 101 - 50;
+  }
+}
+
+// the predicated load from Table stays within the array for all (rounded up) vector iterations: it becomes an unmasked load
+extern "C" int
+foo(int * A, int * B, int n) {
+  fillTable();
+  int m = n < 1000 ? n : 1000;
+  int a = 0;
+  for (int i = 0; i < m; ++i) {
+    if (A[i] > 0) {
+      B[i] = Table[i] + A[i];
+    }
+    a += B[i];
+  }
+  return a;
+}
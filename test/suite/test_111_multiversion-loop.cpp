@@ -0,0 +1,12 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_MULTI_VERSION=1
+
+// the cost model picks the widths: short trip counts run in the narrow vector loop (or the scalar loop)
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i < n; ++i) {
+    B[i] = A[i] * A[i] - 7;
+    a += B[i];
+  }
+  return a;
+}
@@ -0,0 +1,12 @@
+// LaunchCode: fooABnr, Pass: loopvec, Env: RV_PEEL_ALIGN=1
+
+// a scalar prologue runs until the stores to B + 1 are aligned
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  for (int i = 0; i + 1 < n; ++i) {
+    B[i + 1] = A[i] + 3 * A[i + 1];
+    a += A[i];
+  }
+  return a;
+}
@@ -0,0 +1,14 @@
+// LaunchCode: fooABnr, Pass: loopvec
+
+// pointer induction (p != end exit) with a reverse contiguous load
+extern "C" int
+foo(int * A, int * B, int n) {
+  int a = 0;
+  int * end = B + n;
+  const int * q = A + n - 1;
+  for (int * p = B; p != end; ++p, --q) {
+    *p = *q - 2;
+    a += *q;
+  }
+  return a;
+}
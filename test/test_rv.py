@@ -23,6 +23,8 @@ Shapes: <ArgumentShapes>[r<ReturnValueShape] // WFV only
 Width: <vectorizationFactor>
 ULPMathPrec: <ULPError*10> // ULP error bound on math functions (in 10*ULP)
 VarShape[<GlobalVariable>]=<Shape> // Assign shape <Shape> to value <GlobalVariable>
+Pass: loopvec // Loop only: run RV's loop vectorizer pass (instead of vectorizing the first loop directly)
+Env: <VAR=value> <VAR2=value> // Environment of rvTool (eg RV_* flags for the loop vectorizer pass)
 """
   print(text)
 
@@ -62,9 +64,13 @@ class TestCase:
 
     self.options['extraShapes'] = dict()
 
-    # default outer loop stencil
-    self.options['width'] = 8 if self.mode == 'loop' else None
+    self.options['width'] = None
     self.options['loopHint'] = 0
+    self.options['loopPass'] = False
+    self.options['env'] = dict()
+    self.options['cflags'] = ""
+    self.options['vecLib'] = None
+    self.options['interleave'] = None
 
     for option in sigInfo:
       opSplit = option.split(":")
@@ -85,6 +91,18 @@ class TestCase:
         self.options['width'] = int(rhsPart)
       elif lhsPart == "ULPMathPrec":
         self.options['ulp_math_prec'] = int(rhsPart)
+      elif lhsPart == "Pass":
+        self.options['loopPass'] = rhsPart == "loopvec"
+      elif lhsPart == "CFlags":
+        self.options['cflags'] = rhsPart
+      elif lhsPart == "Interleave":
+        self.options['interleave'] = int(rhsPart)
+      elif lhsPart == "VecLib":
+        self.options['vecLib'] = rhsPart
+      elif lhsPart == "Env":
+        for assignment in rhsPart.split():
+          varName, varValue = assignment.split("=")
+          self.options['env'][varName] = varValue
       else:
         namedMatch = re.search("\[(.*)\]", option)
         if not namedMatch is None:
@@ -93,6 +111,10 @@ class TestCase:
           keyName = namedMatch.groups()[0]
           self.options['extraShapes'][keyName] = rhsPart
 
+    # default outer loop stencil (the loop vectorizer pass picks its own width unless the test pins it)
+    if self.mode == 'loop' and self.options['width'] is None and not self.options['loopPass']:
+      self.options['width'] = 8
+
   def requestLauncher(self, prefix, profileMode):
     launcherCpp = "launcher/" + prefix + "_" + self.options['launchCode'] + ".cpp"
     return (launcherCpp, "-Ilauncher/include")
@@ -229,7 +251,7 @@ class HostClangToolchain(Toolchain):
 
     def buildTestRunner(self, testCase, profileMode):
       scalarLL = testCase.getFilename('scalarLL')
-      self.clang.compileToIR(testCase.srcFile, scalarLL)
+      self.clang.compileToIR(testCase.srcFile, scalarLL, testCase.options['cflags'] + " ")
 
       if test.mode == "wfv":
         return self.buildWFVTester(testCase, profileMode)
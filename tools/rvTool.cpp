@@ -26,6 +26,8 @@
 #include <llvm/Analysis/ScalarEvolution.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
 
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/ADT/Triple.h"
 #include "llvm/Analysis/LoopInfo.h"
 #include "llvm/IR/LegacyPassManager.h"
 #include "llvm/IR/Verifier.h"
@@ -40,6 +42,8 @@
 #include "ArgumentReader.h"
 
 #include "rv/passes.h"
+#include "rv/LinkAllPasses.h"
+#include "rv/config.h"
 #include "rv/resolver/resolvers.h"
 #include "rv/rv.h"
 #include "rv/rvDebug.h"
@@ -73,6 +77,9 @@ static const char VARCHAR = 'T';
 static bool verbose = false;
 #define IF_VERBOSE if (verbose)
 
+// vector math library of TargetLibraryInfo (as with clang's -fveclib)
+static std::string vecLibName;
+
 static void LLVM_ATTRIBUTE_NORETURN fail();
 
 static void fail() {
@@ -86,6 +93,24 @@ template <class... Args> static void fail(std::string arg, Args... rest) {
   fail(rest...);
 }
 
+// TargetLibraryInfo for @mod (listing the functions of the vector library, if any)
+static TargetLibraryInfoImpl
+createTLIImpl(Module &mod) {
+  TargetLibraryInfoImpl tlii(Triple(mod.getTargetTriple()));
+  if (vecLibName.empty()) return tlii;
+
+  auto vecLib = StringSwitch<TargetLibraryInfoImpl::VectorLibrary>(vecLibName)
+                    .Case("Accelerate", TargetLibraryInfoImpl::Accelerate)
+                    .Case("MASSV", TargetLibraryInfoImpl::MASSV)
+                    .Case("SVML", TargetLibraryInfoImpl::SVML)
+                    .Default(TargetLibraryInfoImpl::NoLibrary);
+  if (vecLib == TargetLibraryInfoImpl::NoLibrary) {
+    fail("unknown vector library ", vecLibName);
+  }
+  tlii.addVectorizableFunctionsFromVecLib(vecLib);
+  return tlii;
+}
+
 Module *createModuleFromFile(const std::string &fileName,
                              LLVMContext &context) {
   SMDiagnostic diag;
@@ -128,7 +153,7 @@ void vectorizeLoop(Function &parentFn, Loop &TheLoop, unsigned vectorWidth,
   // query LLVM passes
   TargetIRAnalysis irAnalysis;
   TargetTransformInfo tti = irAnalysis.run(parentFn, FAM);
-  TargetLibraryAnalysis libAnalysis;
+  TargetLibraryAnalysis libAnalysis(createTLIImpl(mod));
   TargetLibraryInfo tli = libAnalysis.run(parentFn, FAM);
 
   // set-up for loop vectorization
@@ -166,6 +191,8 @@ void vectorizeLoop(Function &parentFn, Loop &TheLoop, unsigned vectorWidth,
 
   // link in SIMD library
   addSleefResolver(config, platInfo);
+  // vector math library (-veclib)
+  addTLIResolver(config, platInfo);
   // vectorize recursively
   addRecursiveResolver(config, platInfo);
 
@@ -300,6 +327,68 @@ void vectorizeFirstLoop(Function &parentFn, unsigned vectorWidth, int ulpErrorBo
   // run RV
   // replace stride
 }
+// mark @L for vectorization by RV's loop vectorizer with width @vectorWidth (0: the cost model picks the width)
+// interleaving @interleaveCount vector iterations (0: the cost model picks the count)
+// (@assumeParallel: as if it carried a "#pragma omp simd", otw the loop vectorizer has to prove it legal)
+static void
+AnnotateLoopForRV(Loop &L, unsigned vectorWidth, unsigned interleaveCount, bool assumeParallel) {
+  auto &ctx = L.getHeader()->getContext();
+
+  std::vector<Metadata *> mdArgs;
+  mdArgs.push_back(nullptr); // self reference
+  if (assumeParallel) {
+    Metadata *mdEnable[] = {MDString::get(ctx, "rv.loop.vectorize.enable"),
+                            ConstantAsMetadata::get(ConstantInt::getTrue(ctx))};
+    mdArgs.push_back(MDNode::get(ctx, mdEnable));
+  }
+  if (vectorWidth > 0) {
+    Metadata *mdWidth[] = {MDString::get(ctx, "rv.loop.vectorize.width"),
+                           ConstantAsMetadata::get(ConstantInt::get(Type::getInt32Ty(ctx), vectorWidth))};
+    mdArgs.push_back(MDNode::get(ctx, mdWidth));
+  }
+  if (interleaveCount > 0) {
+    Metadata *mdInterleave[] = {MDString::get(ctx, "llvm.loop.interleave.count"),
+                                ConstantAsMetadata::get(ConstantInt::get(Type::getInt32Ty(ctx), interleaveCount))};
+    mdArgs.push_back(MDNode::get(ctx, mdInterleave));
+  }
+
+  MDNode *loopID = MDNode::getDistinct(ctx, mdArgs);
+  loopID->replaceOperandWith(0, loopID);
+  L.setLoopID(loopID);
+}
+
+// Use case: RV's loop vectorizer pass on the first loop
+// (loop vectorizer features are configured with their RV_* environment flags)
+void runLoopVectorizerPass(Function &parentFn, unsigned vectorWidth, unsigned interleaveCount) {
+  normalizeFunction(parentFn);
+
+  {
+    DominatorTree domTree(parentFn);
+    LoopInfo loopInfo(domTree);
+    if (loopInfo.begin() == loopInfo.end()) {
+      fail("no loop to vectorize in ", parentFn.getName().str());
+    }
+
+    // leave the legality checks to the loop vectorizer if it auto-vectorizes
+    auto config = rv::Config::createForFunction(parentFn);
+    AnnotateLoopForRV(**loopInfo.begin(), vectorWidth, interleaveCount, !config.enableAutoVectorization);
+  }
+
+  initializeLoopVectorizerPass(*PassRegistry::getPassRegistry());
+
+  legacy::FunctionPassManager prepFPM(parentFn.getParent());
+  rv::addPreparatoryPasses(prepFPM);
+  prepFPM.run(parentFn);
+
+  // the loop vectorizer reports a change iff it vectorized a loop
+  legacy::FunctionPassManager FPM(parentFn.getParent());
+  FPM.add(new TargetLibraryInfoWrapperPass(createTLIImpl(*parentFn.getParent())));
+  rv::addOuterLoopVectorizer(FPM);
+  if (!FPM.run(parentFn)) {
+    fail("loop vectorizer did not vectorize a loop in ", parentFn.getName().str());
+  }
+}
+
 using ShapeMap = std::map<std::string, rv::VectorShape>;
 
 // Use case: Whole-Function Vectorizer
@@ -316,7 +405,7 @@ void vectorizeFunction(rv::VectorMapping &vectorizerJob, ShapeMap extraShapes, b
   // platform API
   TargetIRAnalysis irAnalysis;
   TargetTransformInfo tti = irAnalysis.run(*scalarFn, FAM);
-  TargetLibraryAnalysis libAnalysis;
+  TargetLibraryAnalysis libAnalysis(createTLIImpl(mod));
   TargetLibraryInfo tli = libAnalysis.run(*scalarFn, FAM);
   rv::PlatformInfo platInfo(mod, &tti, &tli);
 
@@ -364,6 +453,8 @@ void vectorizeFunction(rv::VectorMapping &vectorizerJob, ShapeMap extraShapes, b
 
   // link in SIMD library
   addSleefResolver(config, platInfo);
+  // vector math library (-veclib)
+  addTLIResolver(config, platInfo);
   // vectorize recursively
   addRecursiveResolver(config, platInfo);
 
@@ -506,6 +597,8 @@ static void PrintHelp() {
             << "[-o OUTPUT_LL] [-w 8] [-s SHAPES] [-x GV_SHAPES]\n"
             << "\nCommands:\n"
             << "-wfv/-loopvec      : vectorize a whole-function or an outer loop\n"
+            << "-loopvec-pass      : run the loop vectorizer pass on the first loop "
+               "(RV_* flags configure it).\n"
             << "-analyze           : normalize, print vectorization analysis "
                "results and exit.\n"
             << "-lower-func        : lower predicate intrinsics in scalar kernel.\n"
@@ -524,6 +617,8 @@ static void PrintHelp() {
             << "-x GVSHAPES        : comma-separated list of global value and "
                "function-return shapes, e.g. \"gvar=C,func=S4\".\n"
             << "-w WIDTH           : vectorization factor.\n"
+            << "-ic COUNT          : (loopvec-pass only) interleave count.\n"
+            << "-veclib LIB        : vector math library (Accelerate, MASSV, SVML).\n"
             << "-v                 : enable verbose output (rvTool level output).\n";
 }
 
@@ -542,6 +637,7 @@ int main(int argc, char **argv) {
   OnlyAnalyze = reader.hasOption("-analyze"); // global
   bool wfvMode = reader.hasOption("-wfv");
   bool loopVecMode = reader.hasOption("-loopvec");
+  bool loopVecPassMode = reader.hasOption("-loopvec-pass");
 
   std::string targetDeclName;
   bool hasTargetDeclName = reader.readOption<std::string>("-t", targetDeclName);
@@ -556,6 +652,8 @@ int main(int argc, char **argv) {
 
   bool runNormalize = reader.hasOption("-normalize");
 
+  reader.readOption<std::string>("-veclib", vecLibName);
+
   int ulpErrorBound = 10;
   reader.readOption<int>("--math-prec", ulpErrorBound);
   IF_VERBOSE { errs() << "SLEEF ulpErrorBound: " << (ulpErrorBound/10.0) << "\n"; }
@@ -697,6 +795,12 @@ int main(int argc, char **argv) {
 
     } else if (loopVecMode) {
       vectorizeFirstLoop(*scalarFn, vectorWidth, ulpErrorBound);
+
+    } else if (loopVecPassMode) {
+      // only pin the vector width and interleave count if requested (otw the loop vectorizer's cost model picks them)
+      unsigned interleaveCount = 0;
+      reader.readOption<unsigned>("-ic", interleaveCount);
+      runLoopVectorizerPass(*scalarFn, reader.hasOption("-w") ? vectorWidth : 0, interleaveCount);
     }
 
     if (lowerIntrinsicsFunc) {